@@ -6,107 +6,57 @@ Mail - noorangnaim@gmail.com
 #define ASCENDINGORDERITERATOR_HPP
 
 #include <vector>        // For internal index tracking
-#include <algorithm>     // For sorting
 #include <cstddef>       // For size_t
-#include <stdexcept>     // For exceptions
 
-namespace nooran {
+#include "PositionIterator.hpp" // For the shared stepping, seeking and checks
+#include "IndexBuffer.hpp" // For the shared permutation
 
-    // Forward declaration of the container
-    template<typename T>
-    class MyContainer;
+namespace nooran {
 
     // Iterator that scans the container in ascending order
-    template<typename T>
-    class AscendingOrderIterator {
+    template<typename T, typename Checking = Checked>
+    class AscendingOrderIterator
+        : public PositionIterator<AscendingOrderIterator<T, Checking>, T, Checking> {
     private:
-        const MyContainer<T>* container;   // Pointer to the container we are iterating over
-        std::vector<size_t> sorted_indices; // Stores the indices of elements in sorted order
-        size_t index;                       // Current position in sorted_indices
-        size_t capturedVersion;             // Snapshot of container version for mutation checks
+        using Base = PositionIterator<AscendingOrderIterator<T, Checking>, T, Checking>;
+        friend Base;
 
-    public:
-        // Constructs an iterator at the beginning or end
-        AscendingOrderIterator(const MyContainer<T>& cont, bool is_end = false)
-            : container(&cont), index(0) {
+        IndexBuffer sorted_indices;         // Sorted permutation shared with the container cache
 
-            // Capture version to detect modifications
-            capturedVersion = container->getVersion();
-
-            // Reference to actual data
-            const std::vector<T>& data = container->getData();
-
-            // Prepare sorted indices
-            sorted_indices.resize(data.size());
-            for (size_t i = 0; i < data.size(); ++i) {
-                sorted_indices[i] = i;
-            }
-
-            // Sort indices based on actual element values
-            std::sort(sorted_indices.begin(), sorted_indices.end(),
-                      [&](size_t a, size_t b) {
-                          return data[a] < data[b];
-                      });
-
-            // If asked to create an end iterator, jump to end
-            if (is_end) {
-                index = sorted_indices.size();
-            }
+        // Returns the element at the sorted position
+        const T& elementAt(size_t position) const {
+            return this->container->getData()[(*sorted_indices)[position]];
         }
 
-        // Dereference: returns the current element
-        T operator*() const {
-            // Validate that container hasn't changed
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-
-            // Ensure we are not out of bounds
-            if (index >= sorted_indices.size()) {
-                throw std::out_of_range("Iterator out of range");
-            }
-
-            // Return the element at the sorted position
-            return container->getData()[sorted_indices[index]];
+        // The permutation was built for the data at that time and maps below its size
+        size_t dataExtent() const {
+            return sorted_indices->size();
         }
 
-        // Prefix increment: moves to the next element
-        AscendingOrderIterator& operator++() {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-
-            if (index >= sorted_indices.size()) {
-                throw std::out_of_range("Cannot increment beyond end.");
+        // An end iterator moved back onto an element needs the permutation it skipped
+        void prepare() {
+            if (!sorted_indices && this->index < this->count) {
+                sorted_indices = this->container->getAscendingIndices();
             }
-
-            ++index;
-            return *this;
         }
 
-        // Postfix increment: same as prefix but returns previous state
-        AscendingOrderIterator operator++(int) {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-
-            if (index >= sorted_indices.size()) {
-                throw std::out_of_range("Cannot increment beyond end.");
-            }
-
-            AscendingOrderIterator temp = *this;
-            ++(*this);
-            return temp;
+        // Copies a block with one layout dispatch for the whole block
+        void copyRange(size_t first, size_t n, T* out) const {
+            sorted_indices->gather(this->container->getData().data(), first, n, out);
         }
 
-        // Equality comparison: true if same container and same index
-        bool operator==(const AscendingOrderIterator& other) const {
-            return container == other.container && index == other.index;
-        }
+    public:
+        AscendingOrderIterator() = default;
 
-        // Inequality comparison
-        bool operator!=(const AscendingOrderIterator& other) const {
-            return !(*this == other);
+        // Constructs an iterator at the beginning or end
+        AscendingOrderIterator(const MyContainer<T, Checking>& cont, bool is_end = false)
+            : Base(cont, cont.size(), is_end) {
+
+            // An end iterator never dereferences, so it does not need the permutation
+            if (!is_end) {
+                // Borrow the container's sorted permutation (sorted at most once per version)
+                sorted_indices = cont.getAscendingIndices();
+            }
         }
     };
 
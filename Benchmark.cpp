@@ -0,0 +1,490 @@
+/*
+ * Mail - noorangnaim@gmail.com
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <new>
+#include <cstring>
+#include "MyContainer.hpp"
+
+using namespace nooran;  // Use the project namespace
+
+// Counts every heap allocation, so the payload benchmark can report allocations per traversal
+static std::atomic<size_t> allocation_count{0};
+
+// Kept out of line: once inlined at -O2, GCC pairs the malloc/free calls with new/delete
+// expressions and reports a (false) -Wmismatched-new-delete
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void* operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+BENCH_NOINLINE void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+BENCH_NOINLINE void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+/**
+ * @brief Runs a callable once and returns the elapsed wall time in milliseconds.
+ */
+template<typename Function>
+double timeMs(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/**
+ * @brief Returns n uniformly distributed random values of type T.
+ */
+template<typename T>
+std::vector<T> randomValues(size_t n, unsigned seed) {
+    std::mt19937_64 generator(seed);
+    std::vector<T> values(n);
+    for (T& value : values) {
+        if constexpr (std::is_floating_point<T>::value) {
+            value = static_cast<T>(std::uniform_real_distribution<double>(-1e6, 1e6)(generator));
+        } else {
+            value = static_cast<T>(generator());
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Returns the identity permutation 0..n-1.
+ */
+std::vector<size_t> identity(size_t n) {
+    std::vector<size_t> indices(n);
+    for (size_t i = 0; i < n; ++i) {
+        indices[i] = i;
+    }
+    return indices;
+}
+
+/**
+ * @brief Compares the comparison sort with the radix sort kernel for one element type.
+ * @param max_n Largest input size; sizes grow by 10x starting at 1e3.
+ */
+template<typename T>
+void benchmarkRadix(const std::string& label, size_t max_n) {
+    std::cout << "--- Index sort: " << label << " ---" << std::endl;
+    std::cout << std::setw(12) << "n" << std::setw(16) << "std::sort ms"
+              << std::setw(12) << "radix ms" << std::setw(10) << "speedup" << std::endl;
+
+    for (size_t n = 1000; n <= max_n; n *= 10) {
+        std::vector<T> data = randomValues<T>(n, 42);
+
+        std::vector<size_t> by_comparison = identity(n);
+        double comparison_ms = timeMs([&] { comparisonSortIndices(data, by_comparison); });
+
+        std::vector<size_t> by_radix = identity(n);
+        double radix_ms = timeMs([&] { radixSortIndices(data, by_radix); });
+
+        std::cout << std::setw(12) << n << std::fixed << std::setprecision(2)
+                  << std::setw(16) << comparison_ms << std::setw(12) << radix_ms
+                  << std::setw(9) << comparison_ms / radix_ms << "x" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Compares the indirect comparison sort with sorting contiguous (key, index) pairs.
+ * The time difference on large inputs comes from cache misses of the data[a] < data[b] gather;
+ * run under `perf stat -e cache-misses ./bench` to see the miss counts directly.
+ */
+template<typename T>
+void benchmarkKeyIndexPairs(const std::string& label, size_t max_n) {
+    std::cout << "--- Key/index pair sort: " << label << " ---" << std::endl;
+    std::cout << std::setw(12) << "n" << std::setw(16) << "indirect ms" << std::setw(12) << "pairs ms"
+              << std::setw(12) << "packed ms" << std::setw(12) << "radix ms" << std::endl;
+
+    for (size_t n = 1000; n <= max_n; n *= 10) {
+        std::vector<T> data = randomValues<T>(n, 11);
+
+        std::vector<size_t> indirect = identity(n);
+        double indirect_ms = timeMs([&] { comparisonSortIndices(data, indirect); });
+
+        std::vector<size_t> pairs = identity(n);
+        double pairs_ms = timeMs([&] { pairSortIndices(data, pairs); });
+
+        std::cout << std::setw(12) << n << std::fixed << std::setprecision(2)
+                  << std::setw(16) << indirect_ms << std::setw(12) << pairs_ms;
+        if constexpr (hasPackableKey<T>()) {
+            std::vector<size_t> packed = identity(n);
+            std::cout << std::setw(12) << timeMs([&] { packedSortIndices(data, packed); });
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        std::vector<size_t> radix = identity(n);
+        std::cout << std::setw(12) << timeMs([&] { radixSortIndices(data, radix); }) << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Returns n values with the given presortedness pattern:
+ * sorted, reversed, sawtooth (ascending runs of 1000) or random.
+ */
+std::vector<int> patternValues(const std::string& pattern, size_t n) {
+    std::vector<int> values(n);
+    std::mt19937 generator(3);
+    for (size_t i = 0; i < n; ++i) {
+        if (pattern == "sorted") {
+            values[i] = static_cast<int>(i);
+        } else if (pattern == "reversed") {
+            values[i] = static_cast<int>(n - i);
+        } else if (pattern == "sawtooth") {
+            values[i] = static_cast<int>(i % 1000);
+        } else {
+            values[i] = static_cast<int>(generator());
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Compares std::sort, the natural merge sort and the automatic kernel choice
+ * on inputs with different amounts of existing order.
+ */
+void benchmarkAdaptive(size_t n) {
+    std::cout << "--- Adaptive sort, n = " << n << " ---" << std::endl;
+    std::cout << std::setw(12) << "input" << std::setw(16) << "std::sort ms"
+              << std::setw(14) << "natural ms" << std::setw(12) << "auto ms" << std::endl;
+
+    for (const std::string pattern : {"sorted", "reversed", "sawtooth", "random"}) {
+        std::vector<int> data = patternValues(pattern, n);
+
+        std::vector<size_t> by_comparison = identity(n);
+        double comparison_ms = timeMs([&] { comparisonSortIndices(data, by_comparison); });
+
+        std::vector<size_t> by_natural = identity(n);
+        double natural_ms = timeMs([&] { naturalMergeSortIndices(data, by_natural); });
+
+        std::vector<size_t> by_auto = identity(n);
+        double auto_ms = timeMs([&] { sortIndices(data, by_auto); });
+
+        std::cout << std::setw(12) << pattern << std::fixed << std::setprecision(2)
+                  << std::setw(16) << comparison_ms << std::setw(14) << natural_ms
+                  << std::setw(12) << auto_ms << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Measures the overhead of stable ordering on the comparison path (std::string elements),
+ * against the default unstable comparator and std::stable_sort.
+ */
+void benchmarkStable(size_t max_n) {
+    std::cout << "--- Stable ordering: std::string ---" << std::endl;
+    std::cout << std::setw(12) << "n" << std::setw(14) << "unstable ms" << std::setw(12) << "stable ms"
+              << std::setw(18) << "stable_sort ms" << std::endl;
+
+    for (size_t n = 1000; n <= max_n; n *= 10) {
+        std::vector<int> keys = randomValues<int>(n, 5);
+        std::vector<std::string> data(n);
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = "key-" + std::to_string(static_cast<unsigned>(keys[i]) % (n / 10 + 1));  // ~10 copies each
+        }
+
+        std::vector<size_t> unstable = identity(n);
+        double unstable_ms = timeMs([&] { comparisonSortIndices(data, unstable, false); });
+
+        std::vector<size_t> stable = identity(n);
+        double stable_ms = timeMs([&] { comparisonSortIndices(data, stable, true); });
+
+        std::vector<size_t> reference = identity(n);
+        double reference_ms = timeMs([&] {
+            std::stable_sort(reference.begin(), reference.end(),
+                             [&](size_t a, size_t b) { return data[a] < data[b]; });
+        });
+
+        std::cout << std::setw(12) << n << std::fixed << std::setprecision(2)
+                  << std::setw(14) << unstable_ms << std::setw(12) << stable_ms
+                  << std::setw(18) << reference_ms << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Measures how the parallel sort scales from 1 to the number of hardware threads.
+ */
+template<typename T>
+void benchmarkParallel(const std::string& label, size_t n) {
+    std::cout << "--- Parallel index sort: " << label << ", n = " << n << " ---" << std::endl;
+    std::cout << std::setw(12) << "threads" << std::setw(12) << "ms" << std::setw(10) << "speedup" << std::endl;
+
+    std::vector<T> data = randomValues<T>(n, 7);
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> thread_counts;
+    for (size_t threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);  // Always finish with every hardware thread
+
+    double single_ms = 0;
+    for (size_t threads : thread_counts) {
+        std::vector<size_t> indices = identity(n);
+        double ms = timeMs([&] { parallelSortIndices(data, indices, threads); });
+        if (threads == 1) {
+            single_ms = ms;
+        }
+        std::cout << std::setw(12) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(12) << ms << std::setw(9) << single_ms / ms << "x" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief A 256-byte element, ordered by its first bytes.
+ */
+struct Payload {
+    unsigned char bytes[256];
+
+    bool operator<(const Payload& other) const {
+        return std::memcmp(bytes, other.bytes, sizeof(bytes)) < 0;
+    }
+};
+
+/**
+ * @brief Returns n distinct payloads (std::string longer than the small-string buffer, or Payload).
+ */
+template<typename T>
+std::vector<T> payloadValues(size_t n) {
+    std::vector<int> keys = randomValues<int>(n, 13);
+    std::vector<T> values(n);
+    for (size_t i = 0; i < n; ++i) {
+        if constexpr (std::is_same<T, std::string>::value) {
+            values[i] = "payload-element-" + std::to_string(keys[i]) + "-with-heap-storage";
+        } else {
+            std::memset(values[i].bytes, 0, sizeof(values[i].bytes));
+            std::memcpy(values[i].bytes, &keys[i], sizeof(keys[i]));
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Makes the compiler assume the object is read, so a copy of it cannot be optimized away.
+ */
+template<typename T>
+void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Reads the first byte of an element.
+ */
+unsigned char firstByte(const std::string& value) {
+    return static_cast<unsigned char>(value[0]);
+}
+
+unsigned char firstByte(const Payload& value) {
+    return value.bytes[0];
+}
+
+/**
+ * @brief Compares taking each element by value (what a by-value operator* costs) with
+ * reading it through the returned reference and operator->, over the ascending order.
+ */
+template<typename T>
+void benchmarkDereference(const std::string& label, size_t n) {
+    std::cout << "--- Dereference: " << label << ", n = " << n << " ---" << std::endl;
+    std::cout << std::setw(12) << "access" << std::setw(12) << "ms" << std::setw(16) << "allocations" << std::endl;
+
+    MyContainer<T> container(payloadValues<T>(n));
+    container.getAscendingIndices();  // Sort outside the timed loops
+    size_t checksum = 0;
+
+    auto report = [&](const std::string& access, auto traverse) {
+        size_t allocations_before = allocation_count.load();
+        double ms = timeMs(traverse);
+        std::cout << std::setw(12) << access << std::fixed << std::setprecision(2) << std::setw(12) << ms
+                  << std::setw(16) << allocation_count.load() - allocations_before << std::endl;
+    };
+
+    report("by value", [&] {
+        for (auto it = container.begin_ascending_order(); it != container.end_ascending_order(); ++it) {
+            T copy = *it;
+            doNotOptimize(copy);
+            checksum += firstByte(copy);
+        }
+    });
+    report("reference", [&] {
+        for (const T& element : container.ascending_order()) {
+            checksum += firstByte(element);
+        }
+    });
+    report("operator->", [&] {
+        for (auto it = container.begin_ascending_order(); it != container.end_ascending_order(); ++it) {
+            if constexpr (std::is_same<T, std::string>::value) {
+                checksum += static_cast<unsigned char>(it->front());
+            } else {
+                checksum += it->bytes[0];
+            }
+        }
+    });
+    std::cout << "(checksum " << checksum << ")" << std::endl << std::endl;
+}
+
+/**
+ * @brief Sums one traversal of the insertion and ascending orders under a checking policy
+ * and prints the time per element.
+ */
+template<typename Checking>
+void benchmarkCheckingPolicy(const std::string& label, const std::vector<int>& values, double baseline_ns) {
+    MyContainer<int, Checking> container{std::vector<int>(values)};
+    container.getAscendingIndices();  // Sort outside the timed loops
+    double per_element = 1e6 / static_cast<double>(values.size());
+    long long checksum = 0;
+
+    double order_ms = timeMs([&] {
+        for (int value : container.order()) {
+            checksum += value;
+        }
+    });
+    double ascending_ms = timeMs([&] {
+        for (int value : container.ascending_order()) {
+            checksum += value;
+        }
+    });
+
+    std::cout << std::setw(12) << label << std::fixed << std::setprecision(3)
+              << std::setw(14) << order_ms * per_element << std::setw(16) << ascending_ms * per_element
+              << std::setw(16) << order_ms * per_element - baseline_ns
+              << "   (checksum " << checksum << ")" << std::endl;
+}
+
+/**
+ * @brief Measures the per-element cost of the iterator checks for each checking policy,
+ * against a plain loop over std::vector.
+ * This file is built with NDEBUG, so DebugOnly is Unchecked here.
+ */
+void benchmarkChecking(size_t n) {
+    std::cout << "--- Checking policy, n = " << n << " (ns per element) ---" << std::endl;
+    std::cout << std::setw(12) << "policy" << std::setw(14) << "order" << std::setw(16) << "ascending"
+              << std::setw(16) << "order overhead" << std::endl;
+
+    std::vector<int> values = randomValues<int>(n, 17);
+    long long checksum = 0;
+    double vector_ms = timeMs([&] {
+        for (int value : values) {
+            checksum += value;
+        }
+    });
+    double baseline_ns = vector_ms * 1e6 / static_cast<double>(n);
+    std::cout << std::setw(12) << "std::vector" << std::fixed << std::setprecision(3)
+              << std::setw(14) << baseline_ns << std::setw(16) << "-" << std::setw(16) << 0.0
+              << "   (checksum " << checksum << ")" << std::endl;
+
+    benchmarkCheckingPolicy<Checked>("Checked", values, baseline_ns);
+    benchmarkCheckingPolicy<DebugOnly>("DebugOnly", values, baseline_ns);
+    benchmarkCheckingPolicy<Hoisted>("Hoisted", values, baseline_ns);
+    benchmarkCheckingPolicy<Unchecked>("Unchecked", values, baseline_ns);
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Compares summing a traversal one element at a time with for_each_block,
+ * whose per-block loop over a contiguous buffer the compiler can vectorize.
+ */
+template<typename Range>
+void benchmarkBlockTraversal(const std::string& label, const Range& range, size_t n) {
+    double per_element = 1e6 / static_cast<double>(n);
+    long long element_sum = 0;
+    double element_ms = timeMs([&] {
+        for (int value : range) {
+            element_sum += value;
+        }
+    });
+
+    long long block_sum = 0;
+    double block_ms = timeMs([&] {
+        range.for_each_block(1024, [&](const int* block, size_t count) {
+            long long partial = 0;
+            for (size_t i = 0; i < count; ++i) {
+                partial += block[i];
+            }
+            block_sum += partial;
+        });
+    });
+
+    std::cout << std::setw(12) << label << std::fixed << std::setprecision(3)
+              << std::setw(16) << element_ms * per_element << std::setw(14) << block_ms * per_element
+              << std::setw(9) << element_ms / block_ms << "x"
+              << (element_sum == block_sum ? "" : "   (sum mismatch)") << std::endl;
+}
+
+/**
+ * @brief Measures per-element versus block-wise traversal for several orders (ns per element).
+ */
+void benchmarkBlocks(size_t n) {
+    std::cout << "--- Block iteration, n = " << n << ", blocks of 1024 (ns per element) ---" << std::endl;
+    std::cout << std::setw(12) << "order" << std::setw(16) << "per element" << std::setw(14) << "blocks"
+              << std::setw(10) << "speedup" << std::endl;
+
+    MyContainer<int> container(randomValues<int>(n, 19));
+    container.getAscendingIndices();  // Sort outside the timed loops
+
+    benchmarkBlockTraversal("order", container.order(), n);
+    benchmarkBlockTraversal("reverse", container.reverse_order(), n);
+    benchmarkBlockTraversal("ascending", container.ascending_order(), n);
+    benchmarkBlockTraversal("descending", container.descending_order(), n);
+    benchmarkBlockTraversal("middle-out", container.middle_out_order(), n);
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    // Largest input size; pass e.g. 100000000 to go up to 1e8 elements
+    size_t max_n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    benchmarkRadix<int>("int", max_n);
+    benchmarkRadix<uint64_t>("uint64_t", max_n);
+    benchmarkRadix<float>("float", max_n);
+    benchmarkRadix<double>("double", max_n);
+
+    benchmarkKeyIndexPairs<int>("int", max_n);
+    benchmarkKeyIndexPairs<float>("float", max_n);
+    benchmarkKeyIndexPairs<double>("double", max_n);
+
+    benchmarkAdaptive(max_n);
+    benchmarkStable(max_n);
+
+    benchmarkParallel<int>("int", max_n);
+    benchmarkParallel<double>("double", max_n);
+
+    benchmarkDereference<std::string>("std::string", max_n);
+    benchmarkDereference<Payload>("256-byte struct", max_n);
+
+    benchmarkChecking(max_n);
+    benchmarkBlocks(max_n);
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+Mail - noorangnaim@gmail.com
+*/
+
+#ifndef BOUNDEDORDERITERATOR_HPP
+#define BOUNDEDORDERITERATOR_HPP
+
+#include <vector>        // For the selected indices
+#include <algorithm>     // For heap operations
+#include <functional>    // For std::less and std::greater
+#include <cstddef>       // For size_t
+
+#include "PositionIterator.hpp" // For the shared stepping, seeking and checks
+#include "IndexBuffer.hpp" // For the shared selection
+
+namespace nooran {
+
+    // Iterator over only the first k elements of a sorted order
+    // The k indices are selected with a bounded heap in O(n log k) time and O(k) extra memory,
+    // instead of sorting a full O(n) permutation
+    // Compare is std::greater<T> for the k largest (top-k) and std::less<T> for the k smallest (bottom-k)
+    template<typename T, typename Compare, typename Checking = Checked>
+    class BoundedOrderIterator
+        : public PositionIterator<BoundedOrderIterator<T, Compare, Checking>, T, Checking> {
+    private:
+        using Base = PositionIterator<BoundedOrderIterator<T, Compare, Checking>, T, Checking>;
+        friend Base;
+
+        IndexBuffer selected_indices;      // The min(k, n) selected indices, in order (null for end iterators)
+        size_t selected_from = 0;          // Number of elements the selection was made from
+
+        // Selects the first count elements of the order
+        void select() {
+            const std::vector<T>& data = this->container->getData();
+            size_t count = this->count;
+
+            // Heap ordered so that its top is the selected element that comes last,
+            // which is the one to evict when a better candidate shows up
+            Compare compare;
+            auto order = [&](size_t a, size_t b) {
+                return compare(data[a], data[b]);
+            };
+
+            std::vector<size_t> heap;
+            heap.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                heap.push_back(i);
+            }
+            std::make_heap(heap.begin(), heap.end(), order);
+
+            for (size_t i = count; i < data.size(); ++i) {
+                if (count > 0 && compare(data[i], data[heap.front()])) {
+                    std::pop_heap(heap.begin(), heap.end(), order);
+                    heap.back() = i;
+                    std::push_heap(heap.begin(), heap.end(), order);
+                }
+            }
+
+            // Turn the heap into the final traversal order
+            std::sort_heap(heap.begin(), heap.end(), order);
+            selected_indices = makeIndexBuffer(std::move(heap), data.size());
+            selected_from = data.size();
+        }
+
+        // Returns the element at the selected position
+        const T& elementAt(size_t position) const {
+            return this->container->getData()[(*selected_indices)[position]];
+        }
+
+        // Selected indices can point anywhere in the data they were selected from
+        size_t dataExtent() const {
+            return selected_from;
+        }
+
+        // An end iterator moved back onto an element needs the selection it skipped
+        void prepare() {
+            if (!selected_indices && this->index < this->count) {
+                select();
+            }
+        }
+
+        // Copies a block with one layout dispatch for the whole block
+        void copyRange(size_t first, size_t n, T* out) const {
+            selected_indices->gather(this->container->getData().data(), first, n, out);
+        }
+
+    public:
+        BoundedOrderIterator() = default;
+
+        // Constructs an iterator over the first k elements, at the beginning or end
+        BoundedOrderIterator(const MyContainer<T, Checking>& cont, size_t k, bool is_end = false)
+            : Base(cont, std::min(k, cont.size()), is_end) {
+
+            // End iterators never dereference, so they need no selection
+            if (!is_end) {
+                select();
+            }
+        }
+    };
+
+    // The k largest elements, largest first
+    template<typename T, typename Checking = Checked>
+    using TopKOrderIterator = BoundedOrderIterator<T, std::greater<T>, Checking>;
+
+    // The k smallest elements, smallest first
+    template<typename T, typename Checking = Checked>
+    using BottomKOrderIterator = BoundedOrderIterator<T, std::less<T>, Checking>;
+
+} // namespace nooran
+
+#endif // BOUNDEDORDERITERATOR_HPP
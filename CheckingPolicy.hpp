@@ -0,0 +1,62 @@
+/*
+Mail - noorangnaim@gmail.com
+*/
+
+#ifndef CHECKINGPOLICY_HPP
+#define CHECKINGPOLICY_HPP
+
+#include <cstddef>       // For size_t
+
+namespace nooran {
+
+    // Checking policies decide at compile time whether iterators validate themselves
+    // When enabled is false the per-element version and bounds checks are constant-false
+    // branches, so the compiler drops them and the inner loop is a plain indexed read
+    // When hoisted is true the version is instead checked in the loop condition, only at
+    // the start, every interval positions and at the end of a traversal
+
+    // Every dereference, step and seek checks the container version and the bounds (default)
+    struct Checked {
+        static constexpr bool enabled = true;
+        static constexpr bool hoisted = false;
+    };
+
+    // No checks at all: modifying the container or leaving [begin, end) is undefined behavior
+    struct Unchecked {
+        static constexpr bool enabled = false;
+        static constexpr bool hoisted = false;
+    };
+
+    // Checked in debug builds, unchecked when NDEBUG is defined (like assert)
+    // An alias rather than a type of its own, so translation units built with and without
+    // NDEBUG name two distinct container types instead of two definitions of the same one
+#ifdef NDEBUG
+    using DebugOnly = Unchecked;
+#else
+    using DebugOnly = Checked;
+#endif
+
+    // Validation hoisted out of the per-element path: operator++ and seeks do not check, and
+    // comparing with the end (the loop condition) throws if the container was modified only at
+    // the first position, every interval positions and when the end is reached
+    // operator* still never reads past the data: it throws if the position is at the end or
+    // the container shrank below the elements the traversal was built for
+    // A modification is reported at the latest when the loop finishes, but elements read before
+    // that point may come from the modified container
+    // Where the compiler can prove the guards redundant (insertion, reverse and middle-out order)
+    // a loop costs what an Unchecked one does; sorted orders keep the shrink guard per element
+    // and cost about as much as Checked
+    struct Hoisted {
+        static constexpr bool enabled = false;
+        static constexpr bool hoisted = true;
+        static constexpr size_t interval = 1024;  // Positions between version checks (a power of two)
+    };
+
+    // Forward declaration of the container, shared by all iterator headers
+    // (default arguments may only be given once, so they live here)
+    template<typename T = int, typename Checking = Checked>
+    class MyContainer;
+
+} // namespace nooran
+
+#endif // CHECKINGPOLICY_HPP
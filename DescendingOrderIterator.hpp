@@ -6,95 +6,60 @@ Mail - noorangnaim@gmail.com
 #define DESCENDINGORDERITERATOR_HPP
 
 #include <vector>        // For storing sorted indices
-#include <algorithm>     // For sorting
-#include <stdexcept>     // For exceptions
+#include <cstddef>       // For size_t
 
-namespace nooran {
+#include "PositionIterator.hpp" // For the shared stepping, seeking and checks
+#include "IndexBuffer.hpp" // For the shared permutation
 
-    // Forward declaration of the container class
-    template<typename T>
-    class MyContainer;
+namespace nooran {
 
     // Iterator that scans the container in descending order
-    template<typename T>
-    class DescendingOrderIterator {
+    // It walks the container's ascending permutation from the back, so one sort serves both orders.
+    // In stable mode the container hands out a copy with each run of equal elements reversed
+    // instead, so ties still come out in insertion order.
+    template<typename T, typename Checking = Checked>
+    class DescendingOrderIterator
+        : public PositionIterator<DescendingOrderIterator<T, Checking>, T, Checking> {
     private:
-        const MyContainer<T>* container;      // Pointer to the container being iterated
-        std::vector<size_t> sorted_indices;   // Indices of elements sorted by descending value
-        size_t index;                         // Current position in the sorted_indices
-        size_t capturedVersion;               // Version of the container at iterator creation
-
-    public:
-        // Constructs a descending iterator (begin or end depending on is_end)
-        DescendingOrderIterator(const MyContainer<T>& cont, bool is_end = false)
-            : container(&cont), index(0) {
+        using Base = PositionIterator<DescendingOrderIterator<T, Checking>, T, Checking>;
+        friend Base;
 
-            capturedVersion = container->getVersion(); // Remember container version
+        IndexBuffer sorted_indices;           // Permutation read from the back, shared with the container cache
 
-            const std::vector<T>& data = container->getData(); // Access container data
-
-            // Fill sorted_indices with 0, 1, 2, ..., n-1
-            sorted_indices.resize(data.size());
-            for (size_t i = 0; i < data.size(); ++i) {
-                sorted_indices[i] = i;
-            }
-
-            // Sort indices so that data[sorted_indices[i]] is in descending order
-            std::sort(sorted_indices.begin(), sorted_indices.end(),
-                      [&](size_t a, size_t b) {
-                          return data[a] > data[b];
-                      });
-
-            // If end iterator requested, set index to the end
-            if (is_end) {
-                index = sorted_indices.size();
-            }
+        // Descending position p is ascending position count - 1 - p
+        const T& elementAt(size_t position) const {
+            return this->container->getData()[(*sorted_indices)[this->count - 1 - position]];
         }
 
-        // Returns the element at the current iterator position
-        T operator*() const {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index >= sorted_indices.size()) {
-                throw std::out_of_range("Iterator out of range");
-            }
-            return container->getData()[sorted_indices[index]];
+        // The permutation was built for the data at that time and maps below its size
+        size_t dataExtent() const {
+            return sorted_indices->size();
         }
 
-        // Moves the iterator to the next element (prefix)
-        DescendingOrderIterator& operator++() {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index >= sorted_indices.size()) {
-                throw std::out_of_range("Cannot increment beyond end.");
+        // An end iterator moved back onto an element needs the permutation it skipped
+        void prepare() {
+            if (!sorted_indices && this->index < this->count) {
+                sorted_indices = this->container->getDescendingIndices();
             }
-            ++index;
-            return *this;
         }
 
-        // Moves the iterator to the next element (postfix)
-        DescendingOrderIterator operator++(int) {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index >= sorted_indices.size()) {
-                throw std::out_of_range("Cannot increment beyond end.");
-            }
-            DescendingOrderIterator temp = *this;
-            ++(*this);
-            return temp;
+        // Copies a block by reading the permutation backwards
+        void copyRange(size_t first, size_t n, T* out) const {
+            sorted_indices->gatherBackward(this->container->getData().data(), this->count - 1 - first, n, out);
         }
 
-        // Checks if two iterators are equal (same position and container)
-        bool operator==(const DescendingOrderIterator& other) const {
-            return container == other.container && index == other.index;
-        }
+    public:
+        DescendingOrderIterator() = default;
 
-        // Checks if two iterators are not equal
-        bool operator!=(const DescendingOrderIterator& other) const {
-            return !(*this == other);
+        // Constructs a descending iterator (begin or end depending on is_end)
+        DescendingOrderIterator(const MyContainer<T, Checking>& cont, bool is_end = false)
+            : Base(cont, cont.size(), is_end) {
+
+            // End iterators never dereference, so they skip the permutation entirely
+            if (!is_end) {
+                // Borrow the container's cached permutation (sorted at most once per version)
+                sorted_indices = cont.getDescendingIndices();
+            }
         }
     };
 
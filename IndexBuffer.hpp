@@ -0,0 +1,202 @@
+/*
+Mail - noorangnaim@gmail.com
+*/
+
+#ifndef INDEXBUFFER_HPP
+#define INDEXBUFFER_HPP
+
+#include <vector>        // For the index storage
+#include <memory>        // For std::shared_ptr
+#include <cstdint>       // For the narrow index types
+#include <cstddef>       // For size_t
+#include <algorithm>     // For std::copy_n
+
+namespace nooran {
+
+    // Permutation of element indices stored with the narrowest index type that fits:
+    // 2 bytes per index for up to 65536 elements, 4 bytes up to 2^32, 8 bytes beyond
+    // The identity and reversed permutations (already sorted data) store no indices at all
+    // Reads always return size_t, so code using it does not depend on the layout
+    class IndexPermutation {
+    public:
+        // How the indices are stored
+        enum class Layout { Identity, Reversed, Narrow, Medium, Wide };
+
+    private:
+        std::vector<uint16_t> narrow;   // Used when every index fits in 16 bits
+        std::vector<uint32_t> medium;   // Used when every index fits in 32 bits
+        std::vector<size_t> wide;       // Used otherwise
+        Layout layout;                  // Which of the above is in use (if any)
+        size_t count;                   // Number of indices
+
+        // Constructs an implicit permutation that needs no storage
+        IndexPermutation(Layout implicit_layout, size_t element_count)
+            : layout(implicit_layout), count(element_count) {}
+
+        // Copies values[indices[i]] (or values[indices[-i]] when Backward) into out[i] for i < n
+        // With the index type known the loop has no branches, so the compiler can unroll it
+        template<bool Backward, typename Index, typename T>
+        static void gatherFrom(const Index* indices, const T* values, size_t n, T* out) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = values[Backward ? *(indices - i) : indices[i]];
+            }
+        }
+
+    public:
+        // Stores the given indices of a container with element_count elements
+        IndexPermutation(std::vector<size_t>&& indices, size_t element_count)
+            : count(indices.size()) {
+            if (element_count <= 0x10000u) {
+                layout = Layout::Narrow;
+                narrow.assign(indices.begin(), indices.end());
+            } else if (element_count <= 0x100000000ull) {
+                layout = Layout::Medium;
+                medium.assign(indices.begin(), indices.end());
+            } else {
+                layout = Layout::Wide;
+                wide = std::move(indices);
+            }
+        }
+
+        // Returns the permutation 0, 1, ..., n-1
+        static IndexPermutation identity(size_t n) {
+            return IndexPermutation(Layout::Identity, n);
+        }
+
+        // Returns the permutation n-1, ..., 1, 0
+        static IndexPermutation reversed(size_t n) {
+            return IndexPermutation(Layout::Reversed, n);
+        }
+
+        // Returns the i-th index
+        size_t operator[](size_t i) const {
+            switch (layout) {
+                case Layout::Identity: return i;
+                case Layout::Reversed: return count - 1 - i;
+                case Layout::Narrow:   return narrow[i];
+                case Layout::Medium:   return medium[i];
+                default:               return wide[i];
+            }
+        }
+
+        // Copies values[(*this)[first + i]] into out[i] for i < n
+        // The layout is dispatched once per block rather than once per element
+        template<typename T>
+        void gather(const T* values, size_t first, size_t n, T* out) const {
+            switch (layout) {
+                case Layout::Identity: std::copy_n(values + first, n, out); break;
+                case Layout::Reversed:
+                    for (size_t i = 0; i < n; ++i) {
+                        out[i] = values[count - 1 - first - i];
+                    }
+                    break;
+                case Layout::Narrow:   gatherFrom<false>(narrow.data() + first, values, n, out); break;
+                case Layout::Medium:   gatherFrom<false>(medium.data() + first, values, n, out); break;
+                default:               gatherFrom<false>(wide.data() + first, values, n, out); break;
+            }
+        }
+
+        // Copies values[(*this)[last - i]] into out[i] for i < n (reads the permutation backwards)
+        template<typename T>
+        void gatherBackward(const T* values, size_t last, size_t n, T* out) const {
+            switch (layout) {
+                case Layout::Identity:
+                    for (size_t i = 0; i < n; ++i) {
+                        out[i] = values[last - i];
+                    }
+                    break;
+                case Layout::Reversed: std::copy_n(values + (count - 1 - last), n, out); break;
+                case Layout::Narrow:   gatherFrom<true>(narrow.data() + last, values, n, out); break;
+                case Layout::Medium:   gatherFrom<true>(medium.data() + last, values, n, out); break;
+                default:               gatherFrom<true>(wide.data() + last, values, n, out); break;
+            }
+        }
+
+        // Returns the number of indices
+        size_t size() const {
+            return count;
+        }
+
+        // Returns how the indices are stored
+        Layout getLayout() const {
+            return layout;
+        }
+
+        // Returns the number of bytes stored per index (0 for identity and reversed)
+        size_t getWidth() const {
+            switch (layout) {
+                case Layout::Narrow: return sizeof(uint16_t);
+                case Layout::Medium: return sizeof(uint32_t);
+                case Layout::Wide:   return sizeof(size_t);
+                default:             return 0;
+            }
+        }
+
+        // Returns a copy of the indices as size_t values
+        std::vector<size_t> toVector() const {
+            std::vector<size_t> indices(size());
+            for (size_t i = 0; i < indices.size(); ++i) {
+                indices[i] = (*this)[i];
+            }
+            return indices;
+        }
+    };
+
+    // Immutable, reference-counted permutation of element indices
+    // Once built it is never modified, so the container and any number of
+    // iterators can share it, and copying an iterator only bumps a refcount
+    using IndexBuffer = std::shared_ptr<const IndexPermutation>;
+
+    // Builds an IndexBuffer holding indices of a container with element_count elements
+    inline IndexBuffer makeIndexBuffer(std::vector<size_t>&& indices, size_t element_count) {
+        return std::make_shared<const IndexPermutation>(std::move(indices), element_count);
+    }
+
+    // Lazily filled cache slot: a permutation plus the container version it was built for
+    // Const traversals fill it, so several threads may look it up at the same time; the
+    // entry is immutable and is read and published with std::atomic_load/std::atomic_store,
+    // so a reader sees either the previous entry or a complete new one
+    // (threads that miss together each build a buffer, and the last one stored is kept)
+    class IndexCache {
+    private:
+        struct Entry {
+            IndexBuffer indices;  // Cached permutation
+            size_t version;       // Container version it describes
+        };
+
+        std::shared_ptr<const Entry> entry;  // Null until the first lookup or after reset()
+
+    public:
+        IndexCache() = default;
+
+        // Copies take a consistent snapshot even while another thread refills other
+        IndexCache(const IndexCache& other)
+            : entry(std::atomic_load(&other.entry)) {}
+
+        IndexCache& operator=(const IndexCache& other) {
+            std::atomic_store(&entry, std::atomic_load(&other.entry));
+            return *this;
+        }
+
+        // Returns the buffer built for version, calling build(previous) on a miss
+        // previous is the last buffer stored for any version (null if there is none)
+        template<typename Build>
+        IndexBuffer get(size_t version, Build&& build) {
+            std::shared_ptr<const Entry> cached = std::atomic_load(&entry);
+            if (cached && cached->version == version) {
+                return cached->indices;
+            }
+            IndexBuffer rebuilt = build(cached ? cached->indices : IndexBuffer());
+            std::atomic_store(&entry, std::make_shared<const Entry>(Entry{rebuilt, version}));
+            return rebuilt;
+        }
+
+        // Drops the cached buffer, so the next lookup builds from scratch
+        void reset() {
+            std::atomic_store(&entry, std::shared_ptr<const Entry>());
+        }
+    };
+
+} // namespace nooran
+
+#endif // INDEXBUFFER_HPP
@@ -0,0 +1,128 @@
+/*
+Mail - noorangnaim@gmail.com
+*/
+
+#ifndef LAZYSORTEDORDERITERATOR_HPP
+#define LAZYSORTEDORDERITERATOR_HPP
+
+#include <vector>        // For the heap of indices
+#include <algorithm>     // For std::make_heap and std::pop_heap
+#include <functional>    // For std::less and std::greater
+#include <memory>        // For std::shared_ptr
+#include <atomic>        // For the published pop count
+#include <mutex>         // For serializing pops between copies
+#include <cstddef>       // For size_t
+
+#include "PositionIterator.hpp" // For the shared stepping, seeking and checks
+
+namespace nooran {
+
+    // Iterator that yields the elements in sorted order, but only sorts as far as it is advanced
+    // The indices are heapified in O(n) on construction and each step pops one element in
+    // O(log n), so consuming the first k elements costs O(n + k log n) instead of O(n log n)
+    // Seeking to position p pops up to p; positions already popped are read directly
+    // Compare is std::less<T> for ascending order and std::greater<T> for descending order
+    // Equal elements are visited in insertion order, like the stable sorted orders
+    template<typename T, typename Compare, typename Checking = Checked>
+    class LazySortedOrderIterator
+        : public PositionIterator<LazySortedOrderIterator<T, Compare, Checking>, T, Checking> {
+    private:
+        using Base = PositionIterator<LazySortedOrderIterator<T, Compare, Checking>, T, Checking>;
+        friend Base;
+
+        // Heap state shared by all copies of one traversal
+        // Popped elements are stored at the back of the vector in reverse order:
+        // the element at position p lives at heap[heap.size() - 1 - p]
+        // Copies may be dereferenced from several threads (operator* is const), so pops run
+        // under the mutex and popped is published last; a fixed position is never written
+        // again, so reading one that popped already covers needs no lock
+        struct HeapState {
+            std::vector<size_t> heap;          // Indices; the front part is still a heap
+            std::atomic<size_t> popped{0};     // Number of positions already fixed
+            std::mutex pop_mutex;              // Held while popping
+        };
+
+        std::shared_ptr<HeapState> state;  // Partially sorted indices (null for end iterators)
+
+        // Heap order over indices: the heap top must be the element that comes first, so the
+        // comparison is reversed, and equal elements come out by index (insertion order)
+        static auto heapOrder(const std::vector<T>& data) {
+            return [&data](size_t a, size_t b) {
+                Compare compare;
+                return compare(data[b], data[a]) || (!compare(data[a], data[b]) && b < a);
+            };
+        }
+
+        // Heapifies all indices in O(n)
+        void heapify() {
+            state = std::make_shared<HeapState>();
+            state->heap.resize(this->count);
+            for (size_t i = 0; i < this->count; ++i) {
+                state->heap[i] = i;
+            }
+            std::make_heap(state->heap.begin(), state->heap.end(), heapOrder(this->container->getData()));
+        }
+
+        // Pops from the heap until position p has its final element
+        void settle(size_t p) const {
+            if (state->popped.load(std::memory_order_acquire) > p) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(state->pop_mutex);
+            size_t popped = state->popped.load(std::memory_order_relaxed);
+            auto heap_order = heapOrder(this->container->getData());
+            std::vector<size_t>& heap = state->heap;
+            while (popped <= p) {
+                std::pop_heap(heap.begin(), heap.end() - popped, heap_order);
+                ++popped;
+            }
+            state->popped.store(popped, std::memory_order_release);
+        }
+
+        // Returns the element at position p, sorting just far enough to find it
+        const T& elementAt(size_t position) const {
+            settle(position);
+            return this->container->getData()[state->heap[this->count - 1 - position]];
+        }
+
+        // An end iterator moved back onto an element needs the heap it skipped
+        void prepare() {
+            if (!state && this->index < this->count) {
+                heapify();
+            }
+        }
+
+        // Settles the whole block with one call, then reads the fixed positions
+        void copyRange(size_t first, size_t n, T* out) const {
+            settle(first + n - 1);
+            const std::vector<T>& data = this->container->getData();
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = data[state->heap[this->count - 1 - first - i]];
+            }
+        }
+
+    public:
+        LazySortedOrderIterator() = default;
+
+        // Constructs an iterator at the beginning or end
+        LazySortedOrderIterator(const MyContainer<T, Checking>& cont, bool is_end = false)
+            : Base(cont, cont.size(), is_end) {
+
+            // End iterators never dereference, so they need no heap
+            if (!is_end) {
+                heapify();
+            }
+        }
+    };
+
+    // Lazily sorted ascending traversal
+    template<typename T, typename Checking = Checked>
+    using LazyAscendingOrderIterator = LazySortedOrderIterator<T, std::less<T>, Checking>;
+
+    // Lazily sorted descending traversal
+    template<typename T, typename Checking = Checked>
+    using LazyDescendingOrderIterator = LazySortedOrderIterator<T, std::greater<T>, Checking>;
+
+} // namespace nooran
+
+#endif // LAZYSORTEDORDERITERATOR_HPP
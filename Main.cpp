@@ -20,33 +20,33 @@ void printAllOrders(const MyContainer<T>& container, const std::string& label) {
     std::cout << "Size: " << container.size() << std::endl;
 
     std::cout << "Ascending Order: ";
-    for (auto it = container.begin_ascending_order(); it != container.end_ascending_order(); ++it)
-        std::cout << *it << ' ';
+    for (const T& value : container.ascending_order())
+        std::cout << value << ' ';
     std::cout << std::endl;
 
     std::cout << "Descending Order: ";
-    for (auto it = container.begin_descending_order(); it != container.end_descending_order(); ++it)
-        std::cout << *it << ' ';
+    for (const T& value : container.descending_order())
+        std::cout << value << ' ';
     std::cout << std::endl;
 
     std::cout << "SideCross Order: ";
-    for (auto it = container.begin_side_cross_order(); it != container.end_side_cross_order(); ++it)
-        std::cout << *it << ' ';
+    for (const T& value : container.side_cross_order())
+        std::cout << value << ' ';
     std::cout << std::endl;
 
     std::cout << "Reverse Order: ";
-    for (auto it = container.begin_reverse_order(); it != container.end_reverse_order(); ++it)
-        std::cout << *it << ' ';
+    for (const T& value : container.reverse_order())
+        std::cout << value << ' ';
     std::cout << std::endl;
 
     std::cout << "Order (original): ";
-    for (auto it = container.begin_order(); it != container.end_order(); ++it)
-        std::cout << *it << ' ';
+    for (const T& value : container.order())
+        std::cout << value << ' ';
     std::cout << std::endl;
 
     std::cout << "MiddleOut Order: ";
-    for (auto it = container.begin_middle_out_order(); it != container.end_middle_out_order(); ++it)
-        std::cout << *it << ' ';
+    for (const T& value : container.middle_out_order())
+        std::cout << value << ' ';
     std::cout << "\n" << std::endl;
 }
 
@@ -5,102 +5,39 @@ Mail - noorangnaim@gmail.com
 #ifndef MIDDLEOUTORDERITERATOR_HPP
 #define MIDDLEOUTORDERITERATOR_HPP
 
-#include <vector>        // For internal index storage
-#include <stdexcept>     // For exceptions
+#include <vector>        // For accessing container data
+#include <cstddef>       // For size_t
 
-namespace nooran {
+#include "PositionIterator.hpp" // For the shared stepping, seeking and checks
 
-    // Forward declaration of the container class
-    template<typename T>
-    class MyContainer;
+namespace nooran {
 
     // Iterator that starts from the middle and alternates left and right
-    template<typename T>
-    class MiddleOutOrderIterator {
+    // The k-th position is a closed-form function of mid = n / 2 and k, so the iterator
+    // stores no index vector and construction is O(1) with no heap allocation:
+    //     k = 0 -> mid,  k odd -> mid - (k + 1) / 2,  k even -> mid + k / 2
+    // (the left side always has at least as many elements as the right, so no position is skipped)
+    template<typename T, typename Checking = Checked>
+    class MiddleOutOrderIterator
+        : public PositionIterator<MiddleOutOrderIterator<T, Checking>, T, Checking> {
     private:
-        const MyContainer<T>* container;         // Pointer to the container
-        std::vector<size_t> middle_out_indices;  // Indices in middle-out order
-        size_t index;                            // Current position in the index vector
-        size_t capturedVersion;                  // Version of container at iterator creation
-
-    public:
-        // Constructs a middle-out iterator (begin or end)
-        MiddleOutOrderIterator(const MyContainer<T>& cont, bool is_end = false)
-	    : container(&cont), index(0) {
-
-	    capturedVersion = container->getVersion(); // Save version for validation
-	    const std::vector<T>& data = container->getData();
-	    size_t n = data.size();
-	    middle_out_indices.reserve(n);
-
-	    if (n == 0) return;
-
-	    int mid = n / 2;
-	    middle_out_indices.push_back(mid);
-
-	    for (int offset = 1; middle_out_indices.size() < n; ++offset) {
-		if (mid - offset >= 0)
-		    middle_out_indices.push_back(mid - offset);
-		if (mid + offset < (int)n)
-		    middle_out_indices.push_back(mid + offset);
-	    }
-
-	    if (is_end) {
-		index = middle_out_indices.size(); // Move to end
-	    }
-	}
+        using Base = PositionIterator<MiddleOutOrderIterator<T, Checking>, T, Checking>;
+        friend Base;
 
+        size_t mid = 0;                          // Index of the middle element (n / 2)
 
-
-        // Returns the current element
-        T operator*() const {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index >= middle_out_indices.size()) {
-                throw std::out_of_range("Iterator out of range");
-            }
-            return container->getData()[middle_out_indices[index]];
-        }
-
-        // Moves to the next element (prefix)
-        MiddleOutOrderIterator& operator++() {
-           
-	    if (index + 1 > middle_out_indices.size()) {
-		throw std::out_of_range("Cannot increment beyond end.");
-	    }
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index >= middle_out_indices.size()) {
-                throw std::out_of_range("Cannot increment beyond end.");
-            }
-            ++index;
-            return *this;
-        }
-
-        // Moves to the next element (postfix)
-        MiddleOutOrderIterator operator++(int) {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index >= middle_out_indices.size()) {
-                throw std::out_of_range("Cannot increment beyond end.");
-            }
-            MiddleOutOrderIterator temp = *this;
-            ++(*this);
-            return temp;
+        // Odd steps go left of the middle, even steps go right
+        const T& elementAt(size_t step) const {
+            size_t position = (step % 2 == 1) ? mid - (step + 1) / 2 : mid + step / 2;
+            return this->container->getData()[position];
         }
 
-        // Checks if iterators are equal (same container and index)
-        bool operator==(const MiddleOutOrderIterator& other) const {
-            return container == other.container && index == other.index;
-        }
+    public:
+        MiddleOutOrderIterator() = default;
 
-        // Checks if iterators are not equal
-        bool operator!=(const MiddleOutOrderIterator& other) const {
-            return !(*this == other);
-        }
+        // Constructs a middle-out iterator (begin or end)
+        MiddleOutOrderIterator(const MyContainer<T, Checking>& cont, bool is_end = false)
+            : Base(cont, cont.size(), is_end), mid(cont.size() / 2) {}
     };
 
 } // namespace nooran
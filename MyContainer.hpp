@@ -8,8 +8,16 @@ Mail - noorangnaim@gmail.com
 // Standard library headers
 #include <vector>        // For dynamic storage
 #include <iostream>      // For output stream
-#include <algorithm>     // For std::remove
+#include <algorithm>     // For std::remove_if and std::sort
 #include <stdexcept>     // For throwing exceptions
+#include <thread>        // For std::thread::hardware_concurrency
+#include <iterator>      // For std::iterator_traits and std::distance
+#include <initializer_list> // For addElements({...})
+#include <type_traits>   // For dispatching on the iterator category
+#include <utility>       // For std::move and std::forward
+#include <unordered_set> // For batch removal membership
+#include <functional>    // For std::hash
+#include <unordered_map> // For the multiplicity index
 
 // Custom iterator headers
 #include "AscendingOrderIterator.hpp"
@@ -18,41 +26,463 @@ Mail - noorangnaim@gmail.com
 #include "SideCrossOrderIterator.hpp"
 #include "OrderIterator.hpp"
 #include "MiddleOutOrderIterator.hpp"
+#include "LazySortedOrderIterator.hpp"
+#include "BoundedOrderIterator.hpp"
+#include "OrderRange.hpp"
+#include "CheckingPolicy.hpp"
+#include "IndexBuffer.hpp"
+#include "SortKernels.hpp"
 
 // Define project namespace
 namespace nooran {
 
+    // True if std::hash<T> can hash T (used to pick a hash set or a sorted lookup)
+    template<typename T, typename = void>
+    struct IsHashable : std::false_type {};
+
+    template<typename T>
+    struct IsHashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>> : std::true_type {};
+
+    // Value -> count map used by the membership index; element types that cannot be
+    // hashed or copied get an empty placeholder so the container still compiles for them
+    template<typename T, bool Indexable = IsHashable<T>::value && std::is_copy_constructible<T>::value>
+    struct MultiplicityMap {
+        using type = std::unordered_map<T, size_t>;
+    };
+
+    template<typename T>
+    struct MultiplicityMap<T, false> {
+        struct type {};
+    };
+
     // Generic container for comparable types (default is int)
-    template<typename T = int>
+    // Checking selects how its iterators validate themselves: Checked (default), DebugOnly, Hoisted or Unchecked
+    // (the defaults are given in the declaration in CheckingPolicy.hpp)
+    template<typename T, typename Checking>
     class MyContainer {
     private:
         std::vector<T> data;     // Holds the container's elements
         size_t version = 0;      // Used to track changes for iterator safety
 
+        // Sorted permutation shared by all sort-based iterators (descending order walks it backwards).
+        // It is rebuilt lazily, only when its version tag no longer
+        // matches the container version (i.e. after addElement/removeElement).
+        // A rebuild allocates a fresh buffer, so iterators holding the old one are unaffected.
+        // The slot is thread-safe, so concurrent const traversals may share the container.
+        mutable IndexCache ascending_indices;    // data[(*indices)[i]] is non-decreasing
+        mutable IndexCache descending_indices;   // Stable mode only: ascending with each run of ties reversed
+        mutable IndexCache side_cross_indices;   // Stable mode only: side-cross order at its two-pointer slots
+        bool non_decreasing = true;              // True while data is already in ascending order
+        bool non_increasing = true;              // True while data is already in descending order
+        bool incremental_sorting = false;        // Merge appended elements into the cached order instead of re-sorting
+        bool stable_ordering = false;            // Equal elements keep their insertion order in sorted orders
+        size_t parallel_sort_threshold = PARALLEL_SORT_THRESHOLD;  // Sort on several threads from this size on
+        size_t sort_threads = std::max(1u, std::thread::hardware_concurrency());  // Threads for the parallel sort
+
+        // The multiplicity index copies each distinct value as a hash key, so T must be hashable and copyable
+        static constexpr bool indexable = !std::is_empty<typename MultiplicityMap<T>::type>::value;
+
+        // Optional value -> count map that answers contains/count without scanning data
+        // Only used when T is indexable; kept exact by every add and remove path while enabled
+        bool membership_index = false;                 // True while multiplicity is maintained
+        typename MultiplicityMap<T>::type multiplicity;  // Number of copies of each value in data
+
+        // Returns a new buffer holding 0..n-1 sorted by ascending element value
+        // In incremental mode a cached permutation of a prefix of data is reused: only the
+        // appended tail is sorted and then merged in, which costs O(n + k log k) for k appends
+        IndexBuffer buildSortedIndices(const IndexBuffer& previous) const {
+            // Data that is already ordered needs no sort and no stored indices
+            if (non_decreasing) {
+                return std::make_shared<const IndexPermutation>(IndexPermutation::identity(data.size()));
+            }
+            if (non_increasing && !stable_ordering) {  // Reversing would flip the order of ties
+                return std::make_shared<const IndexPermutation>(IndexPermutation::reversed(data.size()));
+            }
+
+            auto less = [&](size_t a, size_t b) {
+                return data[a] < data[b];
+            };
+
+            size_t sorted_count = 0;  // Leading elements already covered by previous
+            if (incremental_sorting && previous && previous->size() <= data.size()) {
+                sorted_count = previous->size();
+            }
+
+            // Sort only the elements that are not covered yet
+            std::vector<size_t> delta(data.size() - sorted_count);
+            for (size_t i = 0; i < delta.size(); ++i) {
+                delta[i] = sorted_count + i;
+            }
+            if (delta.size() >= parallel_sort_threshold && sort_threads > 1) {
+                parallelSortIndices(data, delta, sort_threads, stable_ordering);
+            } else {
+                sortIndices(data, delta, stable_ordering);  // Radix sort for numeric T, comparison sort otherwise
+            }
+
+            if (sorted_count == 0) {
+                return makeIndexBuffer(std::move(delta), data.size());
+            }
+
+            // Merge the sorted delta into the existing order (older elements first on ties)
+            std::vector<size_t> indices;
+            indices.reserve(data.size());
+            const IndexPermutation& sorted = *previous;
+            size_t i = 0;
+            size_t j = 0;
+            while (i < sorted_count && j < delta.size()) {
+                if (less(delta[j], sorted[i])) {
+                    indices.push_back(delta[j++]);
+                } else {
+                    indices.push_back(sorted[i++]);
+                }
+            }
+            for (; i < sorted_count; ++i) {
+                indices.push_back(sorted[i]);
+            }
+            indices.insert(indices.end(), delta.begin() + j, delta.end());
+            return makeIndexBuffer(std::move(indices), data.size());
+        }
+
+        // Returns the permutation that, read from the back, is the stable descending order
+        // That is the ascending permutation with every run of equal elements reversed, so the
+        // values come out descending and each run in insertion order
+        // Without ties it is the ascending permutation itself and nothing is copied
+        IndexBuffer buildStableDescendingIndices(const IndexBuffer& ascending) const {
+            std::vector<size_t> indices = ascending->toVector();
+            bool has_ties = false;
+            for (size_t first = 0; first < indices.size();) {
+                size_t last = first + 1;
+                while (last < indices.size() && !(data[indices[first]] < data[indices[last]])) {
+                    ++last;
+                }
+                if (last - first > 1) {
+                    std::reverse(indices.begin() + first, indices.begin() + last);
+                    has_ties = true;
+                }
+                first = last;
+            }
+            return has_ties ? makeIndexBuffer(std::move(indices), data.size()) : ascending;
+        }
+
+        // Returns the stable side-cross order laid out for the side-cross iterator, which reads
+        // cross position p at sorted position p / 2 from the front (even p) or the back (odd p)
+        // Each step takes the first element not visited yet from the stable ascending or the
+        // stable descending order, so ties at either end are visited in insertion order
+        IndexBuffer buildStableSideCrossIndices(const IndexPermutation& ascending,
+                                                const IndexPermutation& descending) const {
+            size_t n = data.size();
+            std::vector<size_t> indices(n);
+            std::vector<bool> visited(n, false);
+            size_t front = 0;  // Next candidate in ascending order
+            size_t back = n;   // One past the next candidate in descending order (read from the back)
+            for (size_t p = 0; p < n; ++p) {
+                size_t element;
+                if (p % 2 == 0) {
+                    while (visited[ascending[front]]) {
+                        ++front;
+                    }
+                    element = ascending[front++];
+                } else {
+                    while (visited[descending[back - 1]]) {
+                        --back;
+                    }
+                    element = descending[--back];
+                }
+                visited[element] = true;
+                indices[(p % 2 == 0) ? p / 2 : n - 1 - p / 2] = element;
+            }
+            return makeIndexBuffer(std::move(indices), n);
+        }
+
+        // Updates the sortedness flags for the elements appended from position first onwards
+        // Removing elements never breaks sortedness, so only appends need this
+        void trackSortedness(size_t first) {
+            for (size_t i = std::max<size_t>(first, 1); i < data.size(); ++i) {
+                non_decreasing = non_decreasing && !(data[i] < data[i - 1]);
+                non_increasing = non_increasing && !(data[i - 1] < data[i]);
+            }
+        }
+
+        // Counts the elements appended from position first onwards in the multiplicity index
+        void indexAppended(size_t first) {
+            if constexpr (indexable) {
+                if (membership_index) {
+                    for (size_t i = first; i < data.size(); ++i) {
+                        ++multiplicity[data[i]];
+                    }
+                }
+            }
+        }
+
+        // Removes one copy of value from the multiplicity index
+        void unindex(const T& value) {
+            if constexpr (indexable) {
+                if (membership_index) {
+                    auto entry = multiplicity.find(value);
+                    if (entry != multiplicity.end() && --entry->second == 0) {
+                        multiplicity.erase(entry);
+                    }
+                }
+            }
+        }
+
+        // Drops the cached permutation once it no longer describes a prefix of data
+        void invalidateSortedIndices() {
+            ascending_indices.reset();
+            descending_indices.reset();
+            side_cross_indices.reset();
+        }
+
     public:
         // Creates an empty container
         MyContainer() = default;
 
+        // Creates a container that takes over the given elements without copying them
+        explicit MyContainer(std::vector<T>&& values)
+            : data(std::move(values)) {
+            trackSortedness(0);  // No iterator can exist yet, so the version stays as is
+        }
+
         // Adds an element to the container
         void addElement(const T& value) {
-            data.push_back(value);   // Insert element at the end of the vector
-            version++;               // Mark that the container has changed
+            data.push_back(value);            // Insert element at the end of the vector
+            trackSortedness(data.size() - 1); // Keep the sortedness flags up to date
+            indexAppended(data.size() - 1);   // Keep the multiplicity index up to date
+            version++;                        // Mark that the container has changed
+        }
+
+        // Adds an element to the container by moving it in (no copy; works for move-only types)
+        void addElement(T&& value) {
+            data.push_back(std::move(value));
+            trackSortedness(data.size() - 1);
+            indexAppended(data.size() - 1);
+            version++;
+        }
+
+        // Constructs an element in place at the end of the container from the given arguments
+        template<typename... Args>
+        void emplaceElement(Args&&... args) {
+            data.emplace_back(std::forward<Args>(args)...);
+            trackSortedness(data.size() - 1);
+            indexAppended(data.size() - 1);
+            version++;
+        }
+
+        // Adds all elements of [first, last) at the end of the container
+        // (pass std::make_move_iterator to move them in instead of copying)
+        // Storage is reserved up front (for forward iterators) and the version changes only once,
+        // so incremental sorting sees the whole batch as a single delta
+        template<typename InputIt>
+        void addElements(InputIt first, InputIt last) {
+            using Category = typename std::iterator_traits<InputIt>::iterator_category;
+            if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+                data.reserve(data.size() + static_cast<size_t>(std::distance(first, last)));
+            }
+
+            size_t original_size = data.size();
+            try {
+                for (; first != last; ++first) {
+                    data.push_back(*first);
+                }
+            } catch (...) {
+                // Keep what was added, but never leave iterators unaware of it
+                trackSortedness(original_size);
+                indexAppended(original_size);
+                if (data.size() != original_size) {
+                    version++;
+                }
+                throw;
+            }
+
+            trackSortedness(original_size);
+            indexAppended(original_size);
+            if (data.size() != original_size) {
+                version++;  // One change for the whole batch
+            }
+        }
+
+        // Adds all given elements at the end of the container, e.g. addElements({1, 2, 3})
+        void addElements(std::initializer_list<T> values) {
+            addElements(values.begin(), values.end());
+        }
+
+        // Reserves storage for at least capacity elements (does not change the version)
+        void reserve(size_t capacity) {
+            data.reserve(capacity);
         }
 
         // Removes all instances of the given element from the container
-        // Throws an error if the element does not exist
+        // Throws an error if the element does not exist (without scanning, when the membership index is on)
         void removeElement(const T& value) {
+            // If nothing was removed, the element wasn't found
+            if (tryRemove(value) == 0) {
+                throw std::runtime_error("Element not found in container");
+            }
+        }
+
+        // Removes all instances of the given element, without throwing
+        // Returns how many elements were removed (0 if the element does not exist)
+        size_t tryRemove(const T& value) {
+            if (isMembershipIndexed() && count(value) == 0) {
+                return 0;  // Known absent: skip the linear scan
+            }
+            return removeIf([&](const T& element) { return element == value; });
+        }
+
+        // Removes every element for which pred returns true, in a single compaction pass
+        // Returns how many elements were removed; the version changes at most once
+        template<typename Predicate>
+        size_t removeIf(Predicate pred) {
             auto original_size = data.size(); // Save size before removal
 
-            // Remove all instances of the value
-            data.erase(std::remove(data.begin(), data.end(), value), data.end());
+            // remove_if applies the predicate exactly once per element, so each removed
+            // element is uncounted before it is overwritten
+            data.erase(std::remove_if(data.begin(), data.end(), [&](const T& element) {
+                if (pred(element)) {
+                    unindex(element);
+                    return true;
+                }
+                return false;
+            }), data.end());
 
-            // If size didnt change, the element wasnt found
-            if (data.size() == original_size) {
-                throw std::runtime_error("Element not found in container");
+            size_t removed = original_size - data.size();
+            if (removed > 0) {
+                invalidateSortedIndices(); // Indices shifted, so the cached order cannot be merged into
+                version++; // Mark that the container has changed
+            }
+            return removed;
+        }
+
+        // Removes all instances of every value in the given range, in a single pass over the container
+        // Membership is checked with a hash set when T is hashable, otherwise by binary search
+        // over the sorted values; returns how many elements were removed (never throws when none matched)
+        template<typename Range>
+        size_t removeElements(const Range& values) {
+            if constexpr (IsHashable<T>::value) {
+                std::unordered_set<T> doomed(std::begin(values), std::end(values));
+                if (isMembershipIndexed()) {
+                    // Only values that are actually present need a pass over data
+                    for (auto value = doomed.begin(); value != doomed.end();) {
+                        value = (count(*value) == 0) ? doomed.erase(value) : std::next(value);
+                    }
+                }
+                if (doomed.empty()) {
+                    return 0;
+                }
+                return removeIf([&](const T& element) { return doomed.count(element) > 0; });
+            } else {
+                std::vector<T> doomed(std::begin(values), std::end(values));
+                if (doomed.empty()) {
+                    return 0;
+                }
+                std::sort(doomed.begin(), doomed.end());
+                return removeIf([&](const T& element) {
+                    auto candidate = std::lower_bound(doomed.begin(), doomed.end(), element);
+                    return candidate != doomed.end() && *candidate == element;
+                });
             }
+        }
+
+        // Removes all instances of every given value, e.g. removeElements({1, 2, 3})
+        size_t removeElements(std::initializer_list<T> values) {
+            return removeElements<std::initializer_list<T>>(values);
+        }
+
+        // Enables or disables incremental sorting
+        // When enabled, elements added with addElement are buffered and merged into the
+        // cached sorted order the next time an ordered iterator is requested
+        void setIncrementalSorting(bool enabled) {
+            incremental_sorting = enabled;
+        }
+
+        // Returns true if incremental sorting is enabled
+        bool isIncrementalSorting() const {
+            return incremental_sorting;
+        }
+
+        // Enables or disables stable ordering
+        // When enabled, equal elements appear in insertion order in ascending, descending and
+        // side-cross order; descending and side-cross then use their own cached permutation
+        // (built from the ascending one in O(n)) when the container holds equal elements
+        void setStableOrdering(bool enabled) {
+            if (enabled != stable_ordering) {
+                invalidateSortedIndices();  // The cached order may break ties differently
+            }
+            stable_ordering = enabled;
+        }
+
+        // Returns true if stable ordering is enabled
+        bool isStableOrdering() const {
+            return stable_ordering;
+        }
+
+        // Sets the number of elements from which the sorted permutation is built on several threads
+        void setParallelSortThreshold(size_t threshold) {
+            parallel_sort_threshold = threshold;
+        }
 
-            version++; // Mark that the container has changed
+        // Returns the parallel sort threshold
+        size_t getParallelSortThreshold() const {
+            return parallel_sort_threshold;
+        }
+
+        // Sets how many threads the parallel sort may use (1 disables it)
+        void setSortThreads(size_t threads) {
+            sort_threads = std::max<size_t>(1, threads);
+        }
+
+        // Returns how many threads the parallel sort may use
+        size_t getSortThreads() const {
+            return sort_threads;
+        }
+
+        // Enables or disables the hashed multiplicity index (builds it from the current elements in O(n))
+        // While enabled, contains and count are O(1) and removing an absent value skips the scan
+        // Throws std::logic_error when enabling it for element types without std::hash or a copy constructor
+        void setMembershipIndex(bool enabled) {
+            if constexpr (indexable) {
+                multiplicity.clear();
+                membership_index = enabled;
+                indexAppended(0);
+            } else if (enabled) {
+                throw std::logic_error("Membership index requires a hashable, copyable element type");
+            }
+        }
+
+        // Returns true if the multiplicity index is maintained
+        bool isMembershipIndexed() const {
+            return membership_index;
+        }
+
+        // Returns how many elements equal value (O(1) with the membership index, O(n) otherwise)
+        size_t count(const T& value) const {
+            if constexpr (indexable) {
+                if (membership_index) {
+                    auto entry = multiplicity.find(value);
+                    return entry == multiplicity.end() ? 0 : entry->second;
+                }
+            }
+            return static_cast<size_t>(std::count(data.begin(), data.end(), value));
+        }
+
+        // Returns true if at least one element equals value
+        bool contains(const T& value) const {
+            if constexpr (indexable) {
+                if (membership_index) {
+                    return multiplicity.find(value) != multiplicity.end();
+                }
+            }
+            return std::find(data.begin(), data.end(), value) != data.end();
+        }
+
+        // Returns true if the elements are in non-decreasing insertion order
+        bool isSortedAscending() const {
+            return non_decreasing;
+        }
+
+        // Returns true if the elements are in non-increasing insertion order
+        bool isSortedDescending() const {
+            return non_increasing;
         }
 
         // Returns the number of elements in the container
@@ -65,13 +495,50 @@ namespace nooran {
             return data;
         }
 
+        // Returns the indices of the elements in ascending order (used by sort-based iterators)
+        // The permutation is cached and only re-sorted after the container was modified
+        // Descending order is the same permutation read from the back
+        IndexBuffer getAscendingIndices() const {
+            return ascending_indices.get(version, [this](const IndexBuffer& previous) {
+                return buildSortedIndices(previous);
+            });
+        }
+
+        // Returns the permutation the descending iterator reads from the back
+        // This is the ascending permutation, except in stable mode where ties must keep insertion order
+        IndexBuffer getDescendingIndices() const {
+            IndexBuffer ascending = getAscendingIndices();
+            if (!stable_ordering) {
+                return ascending;
+            }
+            return descending_indices.get(version, [&](const IndexBuffer&) {
+                return buildStableDescendingIndices(ascending);
+            });
+        }
+
+        // Returns the permutation the side-cross iterator walks from both ends
+        // This is the ascending permutation, except in stable mode where ties must keep insertion order
+        IndexBuffer getSideCrossIndices() const {
+            IndexBuffer ascending = getAscendingIndices();
+            if (!stable_ordering) {
+                return ascending;
+            }
+            IndexBuffer descending = getDescendingIndices();
+            if (descending == ascending) {  // No ties, so the plain two-pointer walk is already stable
+                return ascending;
+            }
+            return side_cross_indices.get(version, [&](const IndexBuffer&) {
+                return buildStableSideCrossIndices(*ascending, *descending);
+            });
+        }
+
         // Returns the container version (used by iterators to detect changes)
         size_t getVersion() const {
             return version;
         }
 
         // Prints the container elements in a readable format, e.g. [1, 2, 3]
-        friend std::ostream& operator<<(std::ostream& os, const MyContainer<T>& container) {
+        friend std::ostream& operator<<(std::ostream& os, const MyContainer& container) {
             os << "[";
             for (size_t i = 0; i < container.data.size(); ++i) {
                 os << container.data[i];
@@ -84,96 +551,250 @@ namespace nooran {
         }
 
         // Type aliases so users can write: MyContainer::AscendingIterator
-        AscendingOrderIterator<T> begin_ascending_order() const {  // Begin iterator for ascending order
-            return AscendingOrderIterator<T>(*this, false);  // Return new iterator at start
+        AscendingOrderIterator<T, Checking> begin_ascending_order() const {  // Begin iterator for ascending order
+            return AscendingOrderIterator<T, Checking>(*this, false);  // Return new iterator at start
         }
 
         /**
          * @return Iterator to the end of ascending order
          * @throws None
          */
-        AscendingOrderIterator<T> end_ascending_order() const {  // End iterator for ascending order
-            return AscendingOrderIterator<T>(*this, true);  // Return new iterator at end
+        AscendingOrderIterator<T, Checking> end_ascending_order() const {  // End iterator for ascending order
+            return AscendingOrderIterator<T, Checking>(*this, true);  // Return new iterator at end
         }
 
         /**
          * @return Iterator to the beginning of descending order
          * @throws None
          */
-        DescendingOrderIterator<T> begin_descending_order() const {  // Begin iterator for descending order
-            return DescendingOrderIterator<T>(*this, false);  // Return new iterator at start
+        DescendingOrderIterator<T, Checking> begin_descending_order() const {  // Begin iterator for descending order
+            return DescendingOrderIterator<T, Checking>(*this, false);  // Return new iterator at start
         }
 
         /**
          * @return Iterator to the end of descending order
          * @throws None
          */
-        DescendingOrderIterator<T> end_descending_order() const {  // End iterator for descending order
-            return DescendingOrderIterator<T>(*this, true);  // Return new iterator at end
+        DescendingOrderIterator<T, Checking> end_descending_order() const {  // End iterator for descending order
+            return DescendingOrderIterator<T, Checking>(*this, true);  // Return new iterator at end
         }
 
         /**
          * @return Iterator to the beginning of side-cross order
          * @throws None
          */
-        SideCrossOrderIterator<T> begin_side_cross_order() const {  // Begin iterator for side-cross order
-            return SideCrossOrderIterator<T>(*this, false);  // Return new iterator at start
+        SideCrossOrderIterator<T, Checking> begin_side_cross_order() const {  // Begin iterator for side-cross order
+            return SideCrossOrderIterator<T, Checking>(*this, false);  // Return new iterator at start
         }
 
         /**
          * @return Iterator to the end of side-cross order
          * @throws None
          */
-        SideCrossOrderIterator<T> end_side_cross_order() const {  // End iterator for side-cross order
-            return SideCrossOrderIterator<T>(*this, true);  // Return new iterator at end
+        SideCrossOrderIterator<T, Checking> end_side_cross_order() const {  // End iterator for side-cross order
+            return SideCrossOrderIterator<T, Checking>(*this, true);  // Return new iterator at end
         }
 
         /**
          * @return Iterator to the beginning of reverse order
          * @throws None
          */
-        ReverseOrderIterator<T> begin_reverse_order() const {  // Begin iterator for reverse order
-            return ReverseOrderIterator<T>(*this, false);  // Return new iterator at start
+        ReverseOrderIterator<T, Checking> begin_reverse_order() const {  // Begin iterator for reverse order
+            return ReverseOrderIterator<T, Checking>(*this, false);  // Return new iterator at start
         }
 
         /**
          * @return Iterator to the end of reverse order
          * @throws None
          */
-        ReverseOrderIterator<T> end_reverse_order() const {  // End iterator for reverse order
-            return ReverseOrderIterator<T>(*this, true);  // Return new iterator at end
+        ReverseOrderIterator<T, Checking> end_reverse_order() const {  // End iterator for reverse order
+            return ReverseOrderIterator<T, Checking>(*this, true);  // Return new iterator at end
         }
 
         /**
          * @return Iterator to the beginning of insertion order
          * @throws None
          */
-        OrderIterator<T> begin_order() const {  // Begin iterator for insertion order
-            return OrderIterator<T>(*this, false);  // Return new iterator at start
+        OrderIterator<T, Checking> begin_order() const {  // Begin iterator for insertion order
+            return OrderIterator<T, Checking>(*this, false);  // Return new iterator at start
         }
 
         /**
          * @return Iterator to the end of insertion order
          * @throws None
          */
-        OrderIterator<T> end_order() const {  // End iterator for insertion order
-            return OrderIterator<T>(*this, true);  // Return new iterator at end
+        OrderIterator<T, Checking> end_order() const {  // End iterator for insertion order
+            return OrderIterator<T, Checking>(*this, true);  // Return new iterator at end
         }
 
         /**
          * @return Iterator to the beginning of middle-out order
          * @throws None
          */
-        MiddleOutOrderIterator<T> begin_middle_out_order() const {  // Begin iterator for middle-out order
-            return MiddleOutOrderIterator<T>(*this, false);  // Return new iterator at start
+        MiddleOutOrderIterator<T, Checking> begin_middle_out_order() const {  // Begin iterator for middle-out order
+            return MiddleOutOrderIterator<T, Checking>(*this, false);  // Return new iterator at start
         }
 
         /**
          * @return Iterator to the end of middle-out order
          * @throws None
          */
-        MiddleOutOrderIterator<T> end_middle_out_order() const {  // End iterator for middle-out order
-            return MiddleOutOrderIterator<T>(*this, true);  // Return new iterator at end
+        MiddleOutOrderIterator<T, Checking> end_middle_out_order() const {  // End iterator for middle-out order
+            return MiddleOutOrderIterator<T, Checking>(*this, true);  // Return new iterator at end
+        }
+
+        /**
+         * @return Iterator to the beginning of lazily sorted ascending order
+         * Sorts only as far as the iterator is advanced: O(n + k log n) for k elements
+         * @throws None
+         */
+        LazyAscendingOrderIterator<T, Checking> begin_lazy_ascending_order() const {  // Begin iterator for lazy ascending order
+            return LazyAscendingOrderIterator<T, Checking>(*this, false);  // Return new iterator at start
+        }
+
+        /**
+         * @return Iterator to the end of lazily sorted ascending order
+         * @throws None
+         */
+        LazyAscendingOrderIterator<T, Checking> end_lazy_ascending_order() const {  // End iterator for lazy ascending order
+            return LazyAscendingOrderIterator<T, Checking>(*this, true);  // Return new iterator at end
+        }
+
+        /**
+         * @return Iterator to the beginning of lazily sorted descending order
+         * Sorts only as far as the iterator is advanced: O(n + k log n) for k elements
+         * @throws None
+         */
+        LazyDescendingOrderIterator<T, Checking> begin_lazy_descending_order() const {  // Begin iterator for lazy descending order
+            return LazyDescendingOrderIterator<T, Checking>(*this, false);  // Return new iterator at start
+        }
+
+        /**
+         * @return Iterator to the end of lazily sorted descending order
+         * @throws None
+         */
+        LazyDescendingOrderIterator<T, Checking> end_lazy_descending_order() const {  // End iterator for lazy descending order
+            return LazyDescendingOrderIterator<T, Checking>(*this, true);  // Return new iterator at end
+        }
+
+        /**
+         * @param k Maximum number of elements to visit
+         * @return Iterator to the largest element, visiting the k largest in descending order
+         * Uses O(k) extra memory and O(n log k) time
+         * @throws None
+         */
+        TopKOrderIterator<T, Checking> begin_top_k(size_t k) const {  // Begin iterator for the k largest
+            return TopKOrderIterator<T, Checking>(*this, k, false);  // Return new iterator at start
+        }
+
+        /**
+         * @param k Maximum number of elements to visit
+         * @return Iterator to the end of the k largest elements
+         * @throws None
+         */
+        TopKOrderIterator<T, Checking> end_top_k(size_t k) const {  // End iterator for the k largest
+            return TopKOrderIterator<T, Checking>(*this, k, true);  // Return new iterator at end
+        }
+
+        /**
+         * @param k Maximum number of elements to visit
+         * @return Iterator to the smallest element, visiting the k smallest in ascending order
+         * Uses O(k) extra memory and O(n log k) time
+         * @throws None
+         */
+        BottomKOrderIterator<T, Checking> begin_bottom_k(size_t k) const {  // Begin iterator for the k smallest
+            return BottomKOrderIterator<T, Checking>(*this, k, false);  // Return new iterator at start
+        }
+
+        /**
+         * @param k Maximum number of elements to visit
+         * @return Iterator to the end of the k smallest elements
+         * @throws None
+         */
+        BottomKOrderIterator<T, Checking> end_bottom_k(size_t k) const {  // End iterator for the k smallest
+            return BottomKOrderIterator<T, Checking>(*this, k, true);  // Return new iterator at end
+        }
+
+        /**
+         * @return Range over the ascending order, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<AscendingOrderIterator<T, Checking>> ascending_order() const {  // Begin iterator + end sentinel
+            return OrderRange<AscendingOrderIterator<T, Checking>>(begin_ascending_order(), OrderSentinel(data.size()));
+        }
+
+        /**
+         * @return Range over the descending order, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<DescendingOrderIterator<T, Checking>> descending_order() const {  // Begin iterator + end sentinel
+            return OrderRange<DescendingOrderIterator<T, Checking>>(begin_descending_order(), OrderSentinel(data.size()));
+        }
+
+        /**
+         * @return Range over the side-cross order, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<SideCrossOrderIterator<T, Checking>> side_cross_order() const {  // Begin iterator + end sentinel
+            return OrderRange<SideCrossOrderIterator<T, Checking>>(begin_side_cross_order(), OrderSentinel(data.size()));
+        }
+
+        /**
+         * @return Range over the reverse order, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<ReverseOrderIterator<T, Checking>> reverse_order() const {  // Begin iterator + end sentinel
+            return OrderRange<ReverseOrderIterator<T, Checking>>(begin_reverse_order(), OrderSentinel(data.size()));
+        }
+
+        /**
+         * @return Range over the insertion order, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<OrderIterator<T, Checking>> order() const {  // Begin iterator + end sentinel
+            return OrderRange<OrderIterator<T, Checking>>(begin_order(), OrderSentinel(data.size()));
+        }
+
+        /**
+         * @return Range over the middle-out order, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<MiddleOutOrderIterator<T, Checking>> middle_out_order() const {  // Begin iterator + end sentinel
+            return OrderRange<MiddleOutOrderIterator<T, Checking>>(begin_middle_out_order(), OrderSentinel(data.size()));
+        }
+
+        /**
+         * @return Range over the lazily sorted ascending order, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<LazyAscendingOrderIterator<T, Checking>> lazy_ascending_order() const {  // Begin iterator + end sentinel
+            return OrderRange<LazyAscendingOrderIterator<T, Checking>>(begin_lazy_ascending_order(), OrderSentinel(data.size()));
+        }
+
+        /**
+         * @return Range over the lazily sorted descending order, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<LazyDescendingOrderIterator<T, Checking>> lazy_descending_order() const {  // Begin iterator + end sentinel
+            return OrderRange<LazyDescendingOrderIterator<T, Checking>>(begin_lazy_descending_order(), OrderSentinel(data.size()));
+        }
+
+        /**
+         * @param k Maximum number of elements to visit
+         * @return Range over the k largest elements, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<TopKOrderIterator<T, Checking>> top_k(size_t k) const {  // Begin iterator + end sentinel
+            return OrderRange<TopKOrderIterator<T, Checking>>(begin_top_k(k), OrderSentinel(std::min(k, data.size())));
+        }
+
+        /**
+         * @param k Maximum number of elements to visit
+         * @return Range over the k smallest elements, ending in an O(1) sentinel (usable in range-for)
+         * @throws None
+         */
+        OrderRange<BottomKOrderIterator<T, Checking>> bottom_k(size_t k) const {  // Begin iterator + end sentinel
+            return OrderRange<BottomKOrderIterator<T, Checking>>(begin_bottom_k(k), OrderSentinel(std::min(k, data.size())));
         }
     };
 
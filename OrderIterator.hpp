@@ -6,78 +6,37 @@ Mail - noorangnaim@gmail.com
 #define ORDERITERATOR_HPP
 
 #include <vector>        // For accessing container data
-#include <stdexcept>     // For exception handling
+#include <algorithm>     // For std::copy_n
+#include <cstddef>       // For size_t and std::ptrdiff_t
 
-namespace nooran {
+#include "PositionIterator.hpp" // For the shared stepping, seeking and checks
 
-    // Forward declaration of the container class
-    template<typename T>
-    class MyContainer;
+namespace nooran {
 
     // Iterator that returns elements in the same order they were added
-    template<typename T>
-    class OrderIterator {
+    template<typename T, typename Checking = Checked>
+    class OrderIterator
+        : public PositionIterator<OrderIterator<T, Checking>, T, Checking> {
     private:
-        const MyContainer<T>* container;  // Pointer to the container
-        size_t index;                     // Current position
-        size_t capturedVersion;           // Version snapshot to detect modification
-
-    public:
-        // Constructor for iterator
-        OrderIterator(const MyContainer<T>& cont, bool is_end = false)
-            : container(&cont), index(0) {
-            capturedVersion = cont.getVersion();  // Save version at creation
-            if (is_end) {
-                index = container->getData().size();  // Move to end position
-            }
-        }
+        using Base = PositionIterator<OrderIterator<T, Checking>, T, Checking>;
+        friend Base;
 
-        // Returns the current element
-        T operator*() const {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            const auto& data = container->getData();
-            if (index >= data.size()) {
-                throw std::out_of_range("Iterator out of range");
-            }
-            return data[index];
+        // Position p is element p
+        const T& elementAt(size_t position) const {
+            return this->container->getData()[position];
         }
 
-        // Moves to the next element (prefix)
-        OrderIterator& operator++() {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index >= container->getData().size()) {
-                throw std::out_of_range("Cannot increment beyond end.");
-            }
-            ++index;
-            return *this;
+        // Blocks are contiguous runs of the data
+        void copyRange(size_t first, size_t n, T* out) const {
+            std::copy_n(this->container->getData().begin() + static_cast<std::ptrdiff_t>(first), n, out);
         }
 
-        // Moves to the next element (postfix)
-        OrderIterator operator++(int) {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index >= container->getData().size()) {
-                throw std::out_of_range("Cannot increment beyond end.");
-            }
-            OrderIterator temp = *this;
-            ++(*this);
-            return temp;
-        }
-
-        // Checks if iterators are equal
-        bool operator==(const OrderIterator& other) const {
-            return container == other.container && index == other.index;
-        }
+    public:
+        OrderIterator() = default;
 
-        // Checks if iterators are not equal
-        bool operator!=(const OrderIterator& other) const {
-            return !(*this == other);
-        }
+        // Constructor for iterator
+        OrderIterator(const MyContainer<T, Checking>& cont, bool is_end = false)
+            : Base(cont, cont.size(), is_end) {}
     };
 
 } // namespace nooran
@@ -0,0 +1,76 @@
+/*
+Mail - noorangnaim@gmail.com
+*/
+
+#ifndef ORDERRANGE_HPP
+#define ORDERRANGE_HPP
+
+#include <cstddef>       // For size_t
+#include <vector>        // For the block buffer
+#include <stdexcept>     // For exceptions
+
+namespace nooran {
+
+    // Lightweight end marker for any traversal order
+    // It only remembers the end position, so creating it costs nothing and
+    // comparing an iterator against it is a single integer compare
+    class OrderSentinel {
+    private:
+        size_t position;  // Position one past the last element of the traversal
+
+    public:
+        // Constructs a sentinel for a traversal of the given length
+        explicit OrderSentinel(size_t end_position)
+            : position(end_position) {}
+
+        // Returns the end position this sentinel stands for
+        size_t getPosition() const {
+            return position;
+        }
+    };
+
+    // Begin iterator / end sentinel pair, usable directly in range-for:
+    //     for (int value : container.ascending_order()) { ... }
+    template<typename Iterator>
+    class OrderRange {
+    private:
+        Iterator first;       // Iterator at the start of the traversal
+        OrderSentinel last;   // End marker of the traversal
+
+    public:
+        // Constructs a range from a begin iterator and its end sentinel
+        OrderRange(const Iterator& begin_it, OrderSentinel end_marker)
+            : first(begin_it), last(end_marker) {}
+
+        // Returns the iterator at the start of the range
+        Iterator begin() const {
+            return first;
+        }
+
+        // Returns the end sentinel of the range
+        OrderSentinel end() const {
+            return last;
+        }
+
+        // Visits the traversal in blocks of up to block_size elements, copied into one contiguous buffer:
+        //     range.for_each_block(256, [](const int* block, size_t n) { ... });
+        // The container is validated once per block, and fn can run vectorized code over each block
+        // Throws std::invalid_argument if block_size is 0
+        template<typename Function>
+        void for_each_block(size_t block_size, Function fn) const {
+            using Value = typename Iterator::value_type;
+            if (block_size == 0) {
+                throw std::invalid_argument("Block size must be positive");
+            }
+            std::vector<Value> buffer(block_size);
+            Iterator it = first;
+            size_t n;
+            while ((n = it.next_batch(buffer.data(), block_size)) > 0) {
+                fn(static_cast<const Value*>(buffer.data()), n);
+            }
+        }
+    };
+
+} // namespace nooran
+
+#endif // ORDERRANGE_HPP
@@ -0,0 +1,266 @@
+/*
+Mail - noorangnaim@gmail.com
+*/
+
+#ifndef POSITIONITERATOR_HPP
+#define POSITIONITERATOR_HPP
+
+#include <cstddef>       // For size_t and std::ptrdiff_t
+#include <iterator>      // For std::random_access_iterator_tag
+#include <stdexcept>     // For exceptions
+#include <algorithm>     // For std::min
+
+#include "OrderRange.hpp" // For OrderSentinel
+#include "CheckingPolicy.hpp" // For the checking policies and MyContainer declaration
+
+namespace nooran {
+
+    // Common base of every traversal order (CRTP)
+    // Each order maps a position 0..count-1 to an element, so stepping, seeking, comparing,
+    // block copies and the mutation checks only ever work on the position. The derived
+    // iterator supplies the mapping through its hooks:
+    //     const T& elementAt(size_t position) const        - element at a position (required)
+    //     void prepare()                                    - called after a seek, e.g. to fetch a
+    //                                                         permutation an end iterator skipped
+    //     void copyRange(size_t first, size_t n, T* out)    - faster block copy for next_batch
+    //     size_t dataExtent() const                         - number of elements the mapping was built
+    //                                                         for; every position maps below it
+    template<typename Derived, typename T, typename Checking>
+    class PositionIterator {
+    protected:
+        const MyContainer<T, Checking>* container;  // Pointer to the container we are iterating over
+        size_t index;                               // Current position in the traversal
+        size_t count;                               // Number of positions when the iterator was created
+        size_t capturedVersion;                     // Snapshot of container version for mutation checks
+
+        // Default-constructed iterators only compare equal to each other (required by the iterator concepts)
+        PositionIterator()
+            : container(nullptr), index(0), count(0), capturedVersion(0) {}
+
+        // Starts at position 0, or at length for an end iterator
+        PositionIterator(const MyContainer<T, Checking>& cont, size_t length, bool is_end)
+            : container(&cont), index(is_end ? length : 0), count(length),
+              capturedVersion(cont.getVersion()) {}
+
+        // Throws if the container changed since the iterator was created
+        void checkVersion() const {
+            if (capturedVersion != container->getVersion()) {
+                throw std::runtime_error("Container modified during iteration");
+            }
+        }
+
+        // Hoisted checking: the loop condition validates the version only at the first position,
+        // every Checking::interval positions and at the end, so most steps check nothing
+        // Default-constructed iterators have no container and nothing to validate
+        void validateComparison(size_t end_position) const {
+            if constexpr (Checking::hoisted) {
+                if (container != nullptr && (index == end_position || index % Checking::interval == 0)) {
+                    checkVersion();
+                }
+            }
+        }
+
+        // Default hooks; derived iterators shadow them when they need to
+        void prepare() {}
+
+        size_t dataExtent() const {
+            return count;
+        }
+
+        void copyRange(size_t first, size_t n, T* out) const {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = self().elementAt(first + i);
+            }
+        }
+
+        const Derived& self() const {
+            return static_cast<const Derived&>(*this);
+        }
+
+        Derived& self() {
+            return static_cast<Derived&>(*this);
+        }
+
+    public:
+        // Standard iterator traits, so std::distance, std::advance and std::lower_bound take O(1) steps
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        // Dereference: returns a reference to the current element (no copy)
+        const T& operator*() const {
+            if constexpr (Checking::enabled) {
+                checkVersion();
+            }
+            // Hoisted iterators keep this position compare, so an end iterator is never dereferenced
+            if constexpr (Checking::enabled || Checking::hoisted) {
+                if (index >= count) {
+                    throw std::out_of_range("Iterator out of range");
+                }
+            }
+            // Between two hoisted version checks the container may have shrunk in the loop body;
+            // no read goes past its data, because every position maps below dataExtent()
+            if constexpr (Checking::hoisted) {
+                if (self().dataExtent() > container->size()) {
+                    throw std::runtime_error("Container modified during iteration");
+                }
+            }
+            return self().elementAt(index);
+        }
+
+        // Member access: returns a pointer to the current element (same checks as operator*)
+        const T* operator->() const {
+            return &(**this);
+        }
+
+        // Prefix increment: moves to the next element
+        Derived& operator++() {
+            if constexpr (Checking::enabled) {
+                checkVersion();
+                if (index >= count) {
+                    throw std::out_of_range("Cannot increment beyond end.");
+                }
+            }
+            ++index;
+            return self();
+        }
+
+        // Postfix increment: same as prefix but returns previous state
+        Derived operator++(int) {
+            Derived temp = self();
+            ++(*this);
+            return temp;
+        }
+
+        // Prefix decrement: moves to the previous element
+        Derived& operator--() {
+            if constexpr (Checking::enabled) {
+                checkVersion();
+                if (index == 0) {
+                    throw std::out_of_range("Cannot decrement before beginning.");
+                }
+            }
+            return *this += -1;
+        }
+
+        // Postfix decrement: same as prefix but returns previous state
+        Derived operator--(int) {
+            Derived temp = self();
+            --(*this);
+            return temp;
+        }
+
+        // Moves n positions forward (backward for negative n) in O(1)
+        // Throws if the container changed or the new position would leave [begin, end]
+        Derived& operator+=(difference_type n) {
+            difference_type target = static_cast<difference_type>(index) + n;
+            if constexpr (Checking::enabled) {
+                checkVersion();
+                if (target < 0 || target > static_cast<difference_type>(count)) {
+                    throw std::out_of_range("Iterator moved out of range");
+                }
+            }
+            index = static_cast<size_t>(target);
+            self().prepare();
+            return self();
+        }
+
+        // Moves n positions backward in O(1)
+        Derived& operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        // Returns an iterator n positions ahead
+        Derived operator+(difference_type n) const {
+            Derived result = self();
+            result += n;
+            return result;
+        }
+
+        // Returns an iterator n positions ahead (n + it)
+        friend Derived operator+(difference_type n, const Derived& it) {
+            return it + n;
+        }
+
+        // Returns an iterator n positions back
+        Derived operator-(difference_type n) const {
+            Derived result = self();
+            result -= n;
+            return result;
+        }
+
+        // Number of steps from other to this iterator
+        difference_type operator-(const Derived& other) const {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+
+        // Returns a reference to the element n positions ahead
+        const T& operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        // Ordering by position (both iterators must belong to the same traversal)
+        bool operator<(const Derived& other) const {
+            return index < other.index;
+        }
+
+        bool operator>(const Derived& other) const {
+            return other < self();
+        }
+
+        bool operator<=(const Derived& other) const {
+            return !(other < self());
+        }
+
+        bool operator>=(const Derived& other) const {
+            return !(*this < other);
+        }
+
+        // Copies up to capacity elements, starting at the current one, into out and moves past them
+        // The container version is checked once per block; returns how many were copied (0 at the end)
+        size_t next_batch(T* out, size_t capacity) {
+            if constexpr (Checking::enabled || Checking::hoisted) {
+                checkVersion();
+            }
+            size_t n = std::min(capacity, index < count ? count - index : 0);
+            if (n == 0) {
+                return 0;
+            }
+            self().copyRange(index, n, out);
+            index += n;
+            return n;
+        }
+
+        // Equality comparison: true if same container and same position
+        bool operator==(const Derived& other) const {
+            validateComparison(other.index);
+            return container == other.container && index == other.index;
+        }
+
+        // Inequality comparison
+        bool operator!=(const Derived& other) const {
+            return !(*this == other);
+        }
+
+        // Comparison with an end sentinel: a single position compare
+        // Hoisted iterators test for the end or beyond, which tells the compiler that positions
+        // inside the loop are below the end, so it can drop the bounds check in operator*
+        bool operator==(const OrderSentinel& end) const {
+            validateComparison(end.getPosition());
+            if constexpr (Checking::hoisted) {
+                return index >= end.getPosition();
+            }
+            return index == end.getPosition();
+        }
+
+        // Inequality with an end sentinel
+        bool operator!=(const OrderSentinel& end) const {
+            return !(*this == end);
+        }
+    };
+
+} // namespace nooran
+
+#endif // POSITIONITERATOR_HPP
@@ -6,87 +6,32 @@ Mail - noorangnaim@gmail.com
 #define REVERSEORDERITERATOR_HPP
 
 #include <vector>        // For accessing container data
-#include <stdexcept>     // For throwing exceptions
+#include <cstddef>       // For size_t
 
-namespace nooran {
+#include "PositionIterator.hpp" // For the shared stepping, seeking and checks
 
-    // Forward declaration of the container
-    template<typename T>
-    class MyContainer;
+namespace nooran {
 
     // Iterator that scans elements in reverse of insertion order
-    template<typename T>
-    class ReverseOrderIterator {
+    // The position counts forward, so the end position is size() like every other order
+    template<typename T, typename Checking = Checked>
+    class ReverseOrderIterator
+        : public PositionIterator<ReverseOrderIterator<T, Checking>, T, Checking> {
     private:
-        const MyContainer<T>* container;  // Pointer to the container
-        size_t index;                     // Current index (reverse scan)
-        size_t capturedVersion;           // Version at time of iterator creation
-
-    public:
-        // Constructs a reverse iterator (begin = last, end = before first)
-        ReverseOrderIterator(const MyContainer<T>& cont, bool is_end = false)
-            : container(&cont) {
-
-            capturedVersion = container->getVersion();  // Track version for safety
-
-            if (container->getData().empty()) {
-	    index = static_cast<size_t>(-1);  // Empty container: both begin and end should be the same
-	    } else if (is_end) {
-	    index = static_cast<size_t>(-1);
-	    } else {
-	    index = container->getData().size() - 1;
-	  }
-
-        }
+        using Base = PositionIterator<ReverseOrderIterator<T, Checking>, T, Checking>;
+        friend Base;
 
-        // Returns the current element
-        T operator*() const {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            const auto& data = container->getData();
-            if (index >= data.size()) {
-                throw std::out_of_range("Iterator out of range");
-            }
-            return data[index];
+        // Position 0 is the last element
+        const T& elementAt(size_t position) const {
+            return this->container->getData()[this->count - 1 - position];
         }
 
-        // Moves to the previous element (prefix)
-        ReverseOrderIterator& operator++() {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index == static_cast<size_t>(-1)) {
-                throw std::out_of_range("Cannot increment beyond beginning.");
-            }
-            --index;
-            return *this;
-        }
-
-        // Moves to the previous element (postfix)
-        ReverseOrderIterator operator++(int) {
-            if (capturedVersion != container->getVersion()) {
-                throw std::runtime_error("Container modified during iteration");
-            }
-            if (index == static_cast<size_t>(-1)) {
-                throw std::out_of_range("Cannot increment beyond beginning.");
-            }
-            ReverseOrderIterator temp = *this;
-            --index;
-            return temp;
-        }
-        
-
-
-        // Equality: same container and same index
-        bool operator==(const ReverseOrderIterator& other) const {
-            return container == other.container && index == other.index;
-        }
+    public:
+        ReverseOrderIterator() = default;
 
-        // Inequality: different position or container
-        bool operator!=(const ReverseOrderIterator& other) const {
-            return !(*this == other);
-        }
+        // Constructs a reverse iterator (begin = last, end = before first)
+        ReverseOrderIterator(const MyContainer<T, Checking>& cont, bool is_end = false)
+            : Base(cont, cont.size(), is_end) {}
     };
 
 } // namespace nooran
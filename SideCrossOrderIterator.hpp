@@ -5,118 +5,57 @@ Mail - noorangnaim@gmail.com
 #ifndef SIDECROSSORDERITERATOR_HPP
 #define SIDECROSSORDERITERATOR_HPP
 
-#include <vector>        // For internal storage
-#include <algorithm>     // For sorting
-#include <stdexcept>     // For exceptions
+#include <vector>        // For accessing container data
+#include <cstddef>       // For size_t
 
-namespace nooran {
+#include "PositionIterator.hpp" // For the shared stepping, seeking and checks
+#include "IndexBuffer.hpp" // For the shared permutation
 
-    // Forward declaration of the container class
-    template<typename T>
-    class MyContainer;
+namespace nooran {
 
     // Iterator that alternates between smallest and largest element: left, right, left2, right2...
-    template<typename T>
-    class SideCrossOrderIterator {
+    // The cross order is a two-pointer walk over the sorted order, so the sorted position of
+    // cross position p is computed directly: p / 2 from the front when p is even, from the back when odd
+    // In stable mode the container lays its stable cross order out at those positions instead
+    template<typename T, typename Checking = Checked>
+    class SideCrossOrderIterator
+        : public PositionIterator<SideCrossOrderIterator<T, Checking>, T, Checking> {
     private:
-        const MyContainer<T>* container;       // Pointer to the container
-        std::vector<size_t> cross_indices;     // Indices ordered in side-cross fashion
-        size_t index;                          // Current position in cross_indices
-        size_t capturedVersion;                // Version at the time of iterator creation
-
-    public:
-        // Constructs a side-cross iterator
-        SideCrossOrderIterator(const MyContainer<T>& cont, bool is_end = false)
-            : container(&cont), index(0) {
+        using Base = PositionIterator<SideCrossOrderIterator<T, Checking>, T, Checking>;
+        friend Base;
 
-            capturedVersion = container->getVersion(); // Save version to detect modifications
-
-            const std::vector<T>& data = container->getData();
-            size_t size = data.size();
-
-            if (size == 0) {
-                // For empty container
-                cross_indices = {};
-                if (is_end) {
-                    index = 0;
-                }
-                return;
-            }
-
-            // Initialize indices
-            std::vector<size_t> sorted_indices(size);
-            for (size_t i = 0; i < size; ++i) {
-                sorted_indices[i] = i;
-            }
+        IndexBuffer sorted_indices;            // Sorted permutation shared with the container cache
 
-            // Sort by actual values
-            std::sort(sorted_indices.begin(), sorted_indices.end(),
-                      [&](size_t a, size_t b) {
-                          return data[a] < data[b];
-                      });
+        // Even positions take the next smallest, odd positions the next largest
+        const T& elementAt(size_t position) const {
+            size_t sorted_position = (position % 2 == 0) ? position / 2 : this->count - 1 - position / 2;
+            return this->container->getData()[(*sorted_indices)[sorted_position]];
+        }
 
-            // Build cross order: smallest, largest, 2nd smallest, 2nd largest...
-            size_t left = 0;
-            size_t right = size - 1;
-            while (left <= right) {
-                cross_indices.push_back(sorted_indices[left]);
-                if (left != right) {
-                    cross_indices.push_back(sorted_indices[right]);
-                }
-                left++;
-                right--;
-            }
+        // The permutation was built for the data at that time and maps below its size
+        size_t dataExtent() const {
+            return sorted_indices->size();
+        }
 
-            if (is_end) {
-                index = cross_indices.size(); // Move to end
+        // An end iterator moved back onto an element needs the permutation it skipped
+        void prepare() {
+            if (!sorted_indices && this->index < this->count) {
+                sorted_indices = this->container->getSideCrossIndices();
             }
         }
 
-        // Returns the current element
-	T operator*() const {
-	    if (capturedVersion != container->getVersion()) {
-		throw std::runtime_error("Container modified during iteration");
-	    }
-	    if (!container || index >= cross_indices.size()) {
-		throw std::out_of_range("Iterator out of range");
-	    }
-	    return container->getData()[cross_indices[index]];
-	}
-
-	// Moves to the next element (prefix)
-	SideCrossOrderIterator& operator++() {
-	    if (capturedVersion != container->getVersion()) {
-		throw std::runtime_error("Container modified during iteration");
-	    }
-	    if (!container || index >= cross_indices.size()) {
-		throw std::out_of_range("Cannot increment beyond end.");
-	    }
-	    ++index;
-	    return *this;
-	}
-
-	// Moves to the next element (postfix)
-	SideCrossOrderIterator operator++(int) {
-	    if (capturedVersion != container->getVersion()) {
-		throw std::runtime_error("Container modified during iteration");
-	    }
-	    if (!container || index >= cross_indices.size()) {
-		throw std::out_of_range("Cannot increment beyond end.");
-	    }
-	    SideCrossOrderIterator temp = *this;
-	    ++(*this);
-	    return temp;
-	}
-
+    public:
+        SideCrossOrderIterator() = default;
 
-        // Checks if two iterators are equal
-        bool operator==(const SideCrossOrderIterator& other) const {
-            return container == other.container && index == other.index;
-        }
+        // Constructs a side-cross iterator
+        SideCrossOrderIterator(const MyContainer<T, Checking>& cont, bool is_end = false)
+            : Base(cont, cont.size(), is_end) {
 
-        // Checks if two iterators are not equal
-        bool operator!=(const SideCrossOrderIterator& other) const {
-            return !(*this == other);
+            // End iterators (and empty containers) need no sorted order at all
+            if (!is_end && this->count > 0) {
+                // Borrow the container's cached permutation (sorted at most once per version)
+                sorted_indices = cont.getSideCrossIndices();
+            }
         }
     };
 
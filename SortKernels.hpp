@@ -0,0 +1,425 @@
+/*
+Mail - noorangnaim@gmail.com
+*/
+
+#ifndef SORTKERNELS_HPP
+#define SORTKERNELS_HPP
+
+#include <vector>        // For index and key buffers
+#include <algorithm>     // For std::sort
+#include <type_traits>   // For compile-time dispatch on the element type
+#include <limits>        // For std::numeric_limits
+#include <cstring>       // For std::memcpy
+#include <cstdint>       // For fixed-width key types
+#include <cstddef>       // For size_t
+#include <utility>       // For std::pair
+#include <thread>        // For the parallel sort workers
+#include <exception>     // For forwarding worker exceptions
+
+namespace nooran {
+
+    // Below this many indices the comparison sort wins over radix passes
+    constexpr size_t RADIX_SORT_THRESHOLD = 256;
+
+    // Inputs whose natural runs average at least this many elements are merged instead of sorted
+    constexpr size_t PRESORTED_MIN_AVERAGE_RUN = 32;
+
+    // Default container size from which the permutation is sorted on several threads
+    constexpr size_t PARALLEL_SORT_THRESHOLD = 1 << 20;
+
+    // Maps an element type to an unsigned key whose natural order matches the element order
+    // Only specialised (is_radix_sortable == true) for integers and IEEE-754 float/double
+    template<typename T, typename Enable = void>
+    struct RadixKey {
+        static constexpr bool is_radix_sortable = false;
+    };
+
+    // Integers: unsigned values are their own key, signed values get their sign bit flipped
+    template<typename T>
+    struct RadixKey<T, typename std::enable_if<std::is_integral<T>::value &&
+                                               !std::is_same<T, bool>::value>::type> {
+        static constexpr bool is_radix_sortable = true;
+        using Key = typename std::make_unsigned<T>::type;
+
+        static Key toKey(T value) {
+            Key key = static_cast<Key>(value);
+            if constexpr (std::is_signed<T>::value) {
+                key ^= Key(1) << (sizeof(Key) * 8 - 1);  // Negative values now sort below positive ones
+            }
+            return key;
+        }
+    };
+
+    // Floating point: flip all bits of negative values and only the sign bit of positive ones
+    // -0.0 is folded into +0.0 so that equal values stay equal, as they are for operator<
+    template<typename T>
+    struct RadixKey<T, typename std::enable_if<std::is_floating_point<T>::value &&
+                                               std::numeric_limits<T>::is_iec559 &&
+                                               (sizeof(T) == 4 || sizeof(T) == 8)>::type> {
+        static constexpr bool is_radix_sortable = true;
+        using Key = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+
+        static Key toKey(T value) {
+            if (value == T(0)) {
+                value = T(0);
+            }
+            Key bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            const Key sign = Key(1) << (sizeof(Key) * 8 - 1);
+            return (bits & sign) ? ~bits : (bits | sign);
+        }
+    };
+
+    // Sorts indices so that data[indices[i]] is non-decreasing, comparing elements with operator<
+    // With stable set, each run of equal elements is then sorted by index. Once the indices are
+    // sorted, equal elements sit next to each other, so finding the runs takes n - 1 comparisons
+    // and the tie-break sorts plain integers. This gives the std::stable_sort result without its
+    // extra buffer, and without a second element comparison inside every sort step
+    template<typename T>
+    void comparisonSortIndices(const std::vector<T>& data, std::vector<size_t>& indices, bool stable = false) {
+        std::sort(indices.begin(), indices.end(),
+                  [&](size_t a, size_t b) {
+                      return data[a] < data[b];
+                  });
+        if (!stable) {
+            return;
+        }
+        for (size_t first = 0; first < indices.size(); ) {
+            size_t last = first + 1;
+            while (last < indices.size() && !(data[indices[first]] < data[indices[last]])) {
+                ++last;
+            }
+            if (last - first > 1) {
+                std::sort(indices.begin() + first, indices.begin() + last);
+            }
+            first = last;
+        }
+    }
+
+    // Sorts indices by sorting contiguous (value, index) pairs and only emitting the indices at the end
+    // Comparisons read the copied values next to each other instead of gathering data[a] and data[b]
+    // from random places, which keeps the sort in cache for large containers
+    // Ties are broken by index, so the result is also stable
+    template<typename T>
+    void pairSortIndices(const std::vector<T>& data, std::vector<size_t>& indices) {
+        std::vector<std::pair<T, size_t>> pairs;
+        pairs.reserve(indices.size());
+        for (size_t index : indices) {
+            pairs.emplace_back(data[index], index);
+        }
+        std::sort(pairs.begin(), pairs.end(),
+                  [](const std::pair<T, size_t>& a, const std::pair<T, size_t>& b) {
+                      if (a.first < b.first) return true;
+                      if (b.first < a.first) return false;
+                      return a.second < b.second;
+                  });
+        for (size_t i = 0; i < indices.size(); ++i) {
+            indices[i] = pairs[i].second;
+        }
+    }
+
+    // True if T has a radix key of at most 32 bits, so (key, index) fits one 64-bit word
+    template<typename T>
+    constexpr bool hasPackableKey() {
+        if constexpr (RadixKey<T>::is_radix_sortable) {
+            return sizeof(typename RadixKey<T>::Key) <= 4;
+        } else {
+            return false;
+        }
+    }
+
+    // Sorts indices of 32-bit (or narrower) numeric elements as packed 64-bit words:
+    // the order-preserving key in the high half and the index in the low half
+    // Sorting plain integers needs no gather at all and breaks ties by index (stable)
+    // Requires every index to fit in 32 bits
+    template<typename T>
+    void packedSortIndices(const std::vector<T>& data, std::vector<size_t>& indices) {
+        static_assert(hasPackableKey<T>(), "packedSortIndices needs a key of at most 32 bits");
+        std::vector<uint64_t> words(indices.size());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            uint64_t key = RadixKey<T>::toKey(data[indices[i]]);
+            words[i] = (key << 32) | static_cast<uint64_t>(indices[i]);
+        }
+        std::sort(words.begin(), words.end());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            indices[i] = static_cast<size_t>(words[i] & 0xFFFFFFFFu);
+        }
+    }
+
+    // Sorts indices with an LSD radix sort on (key, index) pairs, one byte per pass
+    // Stable, O(n) per pass, and passes whose byte is identical for every key are skipped
+    template<typename T>
+    void radixSortIndices(const std::vector<T>& data, std::vector<size_t>& indices) {
+        using Traits = RadixKey<T>;
+        using Key = typename Traits::Key;
+        constexpr size_t passes = sizeof(Key);
+        const size_t n = indices.size();
+
+        // Gather (key, index) pairs once, so the passes never touch data again
+        struct Entry {
+            Key key;
+            size_t index;
+        };
+        std::vector<Entry> entries(n);
+        std::vector<size_t> counts(passes * 256, 0);
+        for (size_t i = 0; i < n; ++i) {
+            entries[i] = Entry{Traits::toKey(data[indices[i]]), indices[i]};
+            for (size_t pass = 0; pass < passes; ++pass) {
+                ++counts[pass * 256 + ((entries[i].key >> (pass * 8)) & 0xFF)];
+            }
+        }
+
+        std::vector<Entry> buffer(n);
+        for (size_t pass = 0; pass < passes; ++pass) {
+            size_t* count = &counts[pass * 256];
+
+            // Every key has the same byte here: this pass would not move anything
+            if (n == 0 || count[(entries[0].key >> (pass * 8)) & 0xFF] == n) {
+                continue;
+            }
+
+            // Turn the histogram into starting offsets
+            size_t offset = 0;
+            for (size_t bucket = 0; bucket < 256; ++bucket) {
+                size_t bucket_size = count[bucket];
+                count[bucket] = offset;
+                offset += bucket_size;
+            }
+
+            for (size_t i = 0; i < n; ++i) {
+                buffer[count[(entries[i].key >> (pass * 8)) & 0xFF]++] = entries[i];
+            }
+            entries.swap(buffer);
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            indices[i] = entries[i].index;
+        }
+    }
+
+    // Returns the end of the natural run that starts at indices[first]:
+    // either non-decreasing, or non-increasing when its first strict step goes down
+    template<typename T>
+    size_t naturalRunEnd(const std::vector<T>& data, const std::vector<size_t>& indices, size_t first) {
+        size_t n = indices.size();
+        size_t last = first + 1;
+
+        // Leading equal elements fit either direction, so look past them first
+        while (last < n && !(data[indices[last]] < data[indices[first]]) &&
+               !(data[indices[first]] < data[indices[last]])) {
+            ++last;
+        }
+        if (last >= n) {
+            return n;
+        }
+        if (data[indices[last]] < data[indices[last - 1]]) {
+            while (last < n && !(data[indices[last - 1]] < data[indices[last]])) {
+                ++last;
+            }
+        } else {
+            while (last < n && !(data[indices[last]] < data[indices[last - 1]])) {
+                ++last;
+            }
+        }
+        return last;
+    }
+
+    // Cheap presortedness probe: counts natural runs, but gives up as soon as there are
+    // more than limit of them, so random input is rejected after a short prefix
+    template<typename T>
+    size_t countNaturalRuns(const std::vector<T>& data, const std::vector<size_t>& indices, size_t limit) {
+        size_t runs = 0;
+        for (size_t first = 0; first < indices.size() && runs <= limit; ++runs) {
+            first = naturalRunEnd(data, indices, first);
+        }
+        return runs;
+    }
+
+    // True if the indices are made of few enough runs for the natural merge sort to win
+    template<typename T>
+    bool isPresorted(const std::vector<T>& data, const std::vector<size_t>& indices) {
+        size_t limit = indices.size() / PRESORTED_MIN_AVERAGE_RUN;
+        return countNaturalRuns(data, indices, limit) <= limit;
+    }
+
+    // Natural merge sort: finds the existing ascending and descending runs, reverses the
+    // descending ones and merges neighbouring runs level by level, for O(n log r) on r runs
+    // Stable (ties keep insertion order); O(n) on input that is already sorted or reversed
+    template<typename T>
+    void naturalMergeSortIndices(const std::vector<T>& data, std::vector<size_t>& indices) {
+        const size_t n = indices.size();
+
+        // Run r covers [bounds[r], bounds[r + 1])
+        std::vector<size_t> bounds;
+        for (size_t first = 0; first < n; ) {
+            size_t last = naturalRunEnd(data, indices, first);
+            if (data[indices[last - 1]] < data[indices[first]]) {
+                // Reverse the descending run, then flip each block of equal elements back
+                // so that ties keep their original order
+                std::reverse(indices.begin() + first, indices.begin() + last);
+                for (size_t block = first; block < last; ) {
+                    size_t block_end = block + 1;
+                    while (block_end < last && !(data[indices[block]] < data[indices[block_end]])) {
+                        ++block_end;
+                    }
+                    std::reverse(indices.begin() + block, indices.begin() + block_end);
+                    block = block_end;
+                }
+            }
+            bounds.push_back(first);
+            first = last;
+        }
+        bounds.push_back(n);
+
+        auto less = [&](size_t a, size_t b) {
+            return data[a] < data[b];
+        };
+        std::vector<size_t> buffer(bounds.size() > 2 ? n : 0);
+        while (bounds.size() > 2) {
+            size_t runs = bounds.size() - 1;
+            std::vector<size_t> merged_bounds;
+            for (size_t r = 0; r < runs; r += 2) {
+                size_t first = bounds[r];
+                size_t middle = bounds[std::min(r + 1, runs)];
+                size_t last = bounds[std::min(r + 2, runs)];
+                std::merge(indices.begin() + first, indices.begin() + middle,
+                           indices.begin() + middle, indices.begin() + last,
+                           buffer.begin() + first, less);
+                merged_bounds.push_back(first);
+            }
+            merged_bounds.push_back(n);
+            indices.swap(buffer);
+            bounds.swap(merged_bounds);
+        }
+    }
+
+    // Small trivially copyable elements are cheap enough to copy next to their index
+    template<typename T>
+    constexpr bool isPairSortable() {
+        return std::is_trivially_copyable<T>::value && sizeof(T) <= 16;
+    }
+
+    // Sorts indices by ascending element value, picking the fastest kernel for T:
+    // a natural merge sort when a quick probe finds long existing runs, otherwise (at compile time)
+    // radix sort for large numeric inputs, then packed 64-bit words, then (value, index) pairs,
+    // and the indirect comparison sort only for large or non-trivial element types (e.g. strings)
+    // All kernels except the plain comparison sort are stable already; stable makes that one
+    // break ties by index as well, so equal elements always keep their insertion order
+    template<typename T>
+    void sortIndices(const std::vector<T>& data, std::vector<size_t>& indices, bool stable = false) {
+        if (indices.size() >= 2 * PRESORTED_MIN_AVERAGE_RUN && isPresorted(data, indices)) {
+            naturalMergeSortIndices(data, indices);
+            return;
+        }
+        if constexpr (RadixKey<T>::is_radix_sortable) {
+            if (indices.size() >= RADIX_SORT_THRESHOLD) {
+                radixSortIndices(data, indices);
+                return;
+            }
+        }
+        if constexpr (hasPackableKey<T>()) {
+            if (data.size() <= 0xFFFFFFFFu) {
+                packedSortIndices(data, indices);
+                return;
+            }
+        }
+        if constexpr (isPairSortable<T>()) {
+            pairSortIndices(data, indices);
+            return;
+        }
+        comparisonSortIndices(data, indices, stable);
+    }
+
+    // Runs task(0) .. task(tasks - 1) on their own threads and waits for all of them
+    // The first exception thrown by any task is rethrown on the calling thread
+    // If a thread cannot be started, the tasks still without one run on the calling thread,
+    // so every started worker is joined and the work completes either way
+    template<typename Task>
+    void runInParallel(size_t tasks, Task task) {
+        std::vector<std::exception_ptr> errors(tasks);
+        auto run = [&](size_t t) {
+            try {
+                task(t);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(tasks);
+        size_t spawned = 1;  // Tasks 1 .. spawned - 1 have a thread; task 0 is the caller's
+        try {
+            for (; spawned < tasks; ++spawned) {
+                workers.emplace_back(run, spawned);
+            }
+        } catch (...) {
+            // Out of threads (or memory for one): fall through and run the rest here
+        }
+        run(0);  // The calling thread does its share too
+        for (size_t t = spawned; t < tasks; ++t) {
+            run(t);
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        for (const std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // Parallel merge sort: each thread sorts one chunk with sortIndices, then neighbouring
+    // runs are merged pairwise (also in parallel) until one run is left
+    // Produces the same element sequence as the sequential kernels (and, when stable is set,
+    // the same permutation, since the merges keep the left run first on ties)
+    template<typename T>
+    void parallelSortIndices(const std::vector<T>& data, std::vector<size_t>& indices, size_t threads,
+                             bool stable = false) {
+        const size_t n = indices.size();
+        threads = std::max<size_t>(1, std::min(threads, n / RADIX_SORT_THRESHOLD));
+        if (threads == 1) {
+            sortIndices(data, indices, stable);
+            return;
+        }
+
+        // Chunk boundaries: run r covers [bounds[r], bounds[r + 1])
+        std::vector<size_t> bounds(threads + 1);
+        for (size_t r = 0; r <= threads; ++r) {
+            bounds[r] = n * r / threads;
+        }
+
+        runInParallel(threads, [&](size_t r) {
+            std::vector<size_t> chunk(indices.begin() + bounds[r], indices.begin() + bounds[r + 1]);
+            sortIndices(data, chunk, stable);
+            std::copy(chunk.begin(), chunk.end(), indices.begin() + bounds[r]);
+        });
+
+        auto less = [&](size_t a, size_t b) {
+            return data[a] < data[b];
+        };
+        std::vector<size_t> buffer(n);
+        while (bounds.size() > 2) {
+            size_t runs = bounds.size() - 1;
+            size_t pairs = (runs + 1) / 2;
+            runInParallel(pairs, [&](size_t p) {
+                size_t first = bounds[2 * p];
+                size_t middle = bounds[std::min(2 * p + 1, runs)];
+                size_t last = bounds[std::min(2 * p + 2, runs)];
+                std::merge(indices.begin() + first, indices.begin() + middle,
+                           indices.begin() + middle, indices.begin() + last,
+                           buffer.begin() + first, less);
+            });
+            indices.swap(buffer);
+
+            std::vector<size_t> merged_bounds;
+            for (size_t r = 0; r < runs; r += 2) {
+                merged_bounds.push_back(bounds[r]);
+            }
+            merged_bounds.push_back(n);
+            bounds.swap(merged_bounds);
+        }
+    }
+
+} // namespace nooran
+
+#endif // SORTKERNELS_HPP
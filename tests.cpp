@@ -10,10 +10,38 @@ Mail - noorangnaim@gmail.com
 #include <vector>
 #include <string>
 #include <sstream>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <algorithm>
+#include <thread>
 
 using namespace nooran;
 using namespace std;
 
+// Counts every heap allocation made through operator new, so tests can
+// prove that a code path (e.g. copying an iterator) does not allocate
+// Atomic because the parallel sort allocates from worker threads
+static atomic<size_t> allocation_count{0};
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    if (void* p = malloc(size ? size : 1)) {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
 // Helper function to capture the textual representation of the container
 // so we can easily compare it in string form
 // Example: [1, 2, 3]
@@ -24,6 +52,28 @@ string captureOutput(const MyContainer<T>& c) {
     return oss.str();
 }
 
+// Runs an index-sorting kernel on the identity permutation of data and returns the result
+// kernel is called as kernel(data, indices), like the kernels in SortKernels.hpp
+template<typename T, typename Kernel>
+vector<size_t> sortedBy(const vector<T>& data, Kernel kernel) {
+    vector<size_t> indices(data.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = i;
+    }
+    kernel(data, indices);
+    return indices;
+}
+
+// Returns the elements of data in the order given by indices
+template<typename T>
+vector<T> valuesAt(const vector<T>& data, const vector<size_t>& indices) {
+    vector<T> values;
+    for (size_t index : indices) {
+        values.push_back(data[index]);
+    }
+    return values;
+}
+
 // Template function that tests all iterator types (ascending, descending, etc.)
 // against expected results
 // Also checks invalid access at the end of each iterator
@@ -252,3 +302,1207 @@ TEST_CASE("Double type support") {
 
     testIterators(c, asc, desc, side, rev, order, middle);
 }
+
+// Sort-based iterators share one cached permutation that is rebuilt after modification
+TEST_CASE("Sorted permutation is cached per container version") {
+    MyContainer<int> c;
+    c.addElement(5);
+    c.addElement(1);
+    c.addElement(3);
+
+    IndexBuffer first = c.getAscendingIndices();
+    CHECK(first->toVector() == vector<size_t>{1, 2, 0});
+    CHECK(c.getAscendingIndices() == first);  // Same buffer, no re-sort
+
+    c.addElement(0);  // Bumps the version, so the next request re-sorts
+    CHECK(c.getAscendingIndices()->toVector() == vector<size_t>{3, 1, 2, 0});
+    CHECK(first->toVector() == vector<size_t>{1, 2, 0});  // Old buffer is immutable
+
+    vector<int> result;
+    for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == vector<int>{0, 1, 3, 5});
+
+    c.removeElement(3);
+    result.clear();
+    for (auto it = c.begin_side_cross_order(); it != c.end_side_cross_order(); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == vector<int>{0, 5, 1});
+}
+
+// Const traversals may run on several threads: the first one after a change fills the cache
+TEST_CASE("Concurrent const traversal shares the cached orders") {
+    MyContainer<int> c;
+    for (int i = 0; i < 3000; ++i) {
+        c.addElement((i * 7919) % 1000);
+    }
+    vector<int> expected(c.getData());
+    sort(expected.begin(), expected.end());
+
+    for (int round = 0; round < 4; ++round) {
+        c.addElement(round);  // New version, so every thread finds the cache stale
+        expected.insert(upper_bound(expected.begin(), expected.end(), round), round);
+
+        const MyContainer<int>& shared = c;
+        auto lazy = shared.begin_lazy_ascending_order();  // Copies share one partial heap
+        vector<vector<int>> eager(4), popped(4);
+        vector<thread> readers;
+        for (size_t t = 0; t < 4; ++t) {
+            readers.emplace_back([&, t] {
+                for (int value : shared.ascending_order()) {
+                    eager[t].push_back(value);
+                }
+                auto it = lazy;
+                for (size_t i = 0; i < expected.size(); ++i) {
+                    popped[t].push_back(it[static_cast<ptrdiff_t>(i)]);
+                }
+            });
+        }
+        for (thread& reader : readers) {
+            reader.join();
+        }
+        for (size_t t = 0; t < 4; ++t) {
+            CHECK(eager[t] == expected);
+            CHECK(popped[t] == expected);
+        }
+    }
+}
+
+// Range objects end in a sentinel and work directly in range-for
+TEST_CASE("Range-for over every order with end sentinels") {
+    MyContainer<int> c;
+    c.addElement(7);
+    c.addElement(15);
+    c.addElement(6);
+    c.addElement(1);
+    c.addElement(2);
+
+    auto collect = [](auto range) {
+        vector<int> out;
+        for (int value : range) {
+            out.push_back(value);
+        }
+        return out;
+    };
+
+    CHECK(collect(c.ascending_order()) == vector<int>{1, 2, 6, 7, 15});
+    CHECK(collect(c.descending_order()) == vector<int>{15, 7, 6, 2, 1});
+    CHECK(collect(c.side_cross_order()) == vector<int>{1, 15, 2, 7, 6});
+    CHECK(collect(c.reverse_order()) == vector<int>{2, 1, 6, 15, 7});
+    CHECK(collect(c.order()) == vector<int>{7, 15, 6, 1, 2});
+    CHECK(collect(c.middle_out_order()) == vector<int>{6, 15, 1, 7, 2});
+
+    // Sentinel and end iterator mark the same position
+    auto it = c.begin_reverse_order();
+    for (int i = 0; i < 5; ++i) {
+        CHECK(it != c.reverse_order().end());
+        ++it;
+    }
+    CHECK(it == c.reverse_order().end());
+    CHECK(it == c.end_reverse_order());
+
+    MyContainer<int> empty;
+    CHECK(empty.ascending_order().begin() == empty.ascending_order().end());
+    CHECK(collect(empty.middle_out_order()).empty());
+}
+
+// Copying an iterator shares its index buffer, so postfix increment never allocates
+TEST_CASE("Iterator copies and postfix increment do not allocate") {
+    MyContainer<int> c;
+    for (int i = 0; i < 1000; ++i) {
+        c.addElement((i * 7919) % 1000);
+    }
+
+    auto countAllocations = [](auto it, auto end) {
+        size_t before = allocation_count;
+        long long sum = 0;
+        while (it != end) {
+            auto previous = it++;
+            sum += *previous;
+        }
+        CHECK(sum == 499500);
+        return allocation_count - before;
+    };
+
+    CHECK(countAllocations(c.begin_ascending_order(), c.end_ascending_order()) == 0);
+    CHECK(countAllocations(c.begin_descending_order(), c.end_descending_order()) == 0);
+    CHECK(countAllocations(c.begin_side_cross_order(), c.end_side_cross_order()) == 0);
+    CHECK(countAllocations(c.begin_reverse_order(), c.end_reverse_order()) == 0);
+    CHECK(countAllocations(c.begin_order(), c.end_order()) == 0);
+    CHECK(countAllocations(c.begin_middle_out_order(), c.end_middle_out_order()) == 0);
+}
+
+// Incremental mode merges appended elements into the cached order
+TEST_CASE("Incremental sorting merges appends into the cached permutation") {
+    MyContainer<int> c;
+    c.setIncrementalSorting(true);
+    CHECK(c.isIncrementalSorting());
+
+    MyContainer<int> reference;  // Same contents, always fully re-sorted
+    auto add = [&](int value) {
+        c.addElement(value);
+        reference.addElement(value);
+    };
+
+    for (int value : {9, 4, 7, 1}) {
+        add(value);
+    }
+    IndexBuffer before = c.getAscendingIndices();
+    CHECK(before->toVector() == reference.getAscendingIndices()->toVector());
+
+    for (int value : {5, 0, 9, 3}) {
+        add(value);
+    }
+    CHECK(before->size() == 4);  // Earlier snapshot untouched by the merge
+    CHECK(c.getAscendingIndices()->toVector() == vector<size_t>{5, 3, 7, 1, 4, 2, 0, 6});
+
+    vector<int> result;
+    for (int value : c.descending_order()) {
+        result.push_back(value);
+    }
+    CHECK(result == vector<int>{9, 9, 7, 5, 4, 3, 1, 0});
+
+    // Removal shifts indices, so the next request falls back to a full sort
+    c.removeElement(9);
+    reference.removeElement(9);
+    add(2);
+    result.clear();
+    for (int value : c.ascending_order()) {
+        result.push_back(value);
+    }
+    CHECK(result == vector<int>{0, 1, 2, 3, 4, 5, 7});
+}
+
+// Lazy iterators must produce exactly the same sequence as the fully sorted ones
+TEST_CASE("Lazily sorted iterators match ascending and descending order") {
+    MyContainer<int> c;
+    for (int i = 0; i < 200; ++i) {
+        c.addElement((i * 37) % 50);  // Many duplicates
+    }
+
+    vector<int> eager, lazy;
+    for (int value : c.ascending_order()) {
+        eager.push_back(value);
+    }
+    for (int value : c.lazy_ascending_order()) {
+        lazy.push_back(value);
+    }
+    CHECK(lazy == eager);
+
+    eager.clear();
+    lazy.clear();
+    for (auto it = c.begin_descending_order(); it != c.end_descending_order(); ++it) {
+        eager.push_back(*it);
+    }
+    for (auto it = c.begin_lazy_descending_order(); it != c.end_lazy_descending_order(); it++) {
+        lazy.push_back(*it);
+    }
+    CHECK(lazy == eager);
+
+    // Copies share the partial sort, so an earlier copy still sees its own element
+    auto it = c.begin_lazy_ascending_order();
+    auto first = it++;
+    ++it;
+    CHECK(*it == 0);
+    CHECK(*first == 0);
+
+    // Same safety guarantees as the other iterators
+    auto end = c.end_lazy_ascending_order();
+    CHECK_THROWS_AS(*end, out_of_range);
+    CHECK_THROWS_AS(++end, out_of_range);
+    c.addElement(-1);
+    CHECK_THROWS_AS(*it, runtime_error);
+
+    MyContainer<string> empty;
+    CHECK(empty.begin_lazy_descending_order() == empty.end_lazy_descending_order());
+}
+
+// Top-k / bottom-k visit a prefix of the descending / ascending order
+TEST_CASE("Bounded top-k and bottom-k iterators") {
+    MyContainer<int> c;
+    for (int i = 0; i < 100; ++i) {
+        c.addElement((i * 13) % 100);
+    }
+    c.addElement(99);  // Duplicate of the maximum
+
+    vector<int> result;
+    for (int value : c.top_k(4)) {
+        result.push_back(value);
+    }
+    CHECK(result == vector<int>{99, 99, 98, 97});
+
+    result.clear();
+    for (auto it = c.begin_bottom_k(3); it != c.end_bottom_k(3); ++it) {
+        result.push_back(*it);
+    }
+    CHECK(result == vector<int>{0, 1, 2});
+
+    // k larger than the container visits everything, k == 0 visits nothing
+    size_t visited = 0;
+    for (int value : c.bottom_k(1000)) {
+        (void)value;
+        ++visited;
+    }
+    CHECK(visited == c.size());
+    CHECK(c.begin_top_k(0) == c.end_top_k(0));
+
+    auto end = c.end_top_k(4);
+    CHECK_THROWS_AS(*end, out_of_range);
+    CHECK_THROWS_AS(end++, out_of_range);
+}
+
+// Descending order is the ascending permutation read backwards
+TEST_CASE("Descending order mirrors the shared ascending permutation") {
+    MyContainer<string> c;
+    for (const char* word : {"pear", "fig", "apple", "fig", "kiwi"}) {
+        c.addElement(word);
+    }
+
+    vector<string> ascending, descending;
+    for (const string& value : c.ascending_order()) {
+        ascending.push_back(value);
+    }
+    for (const string& value : c.descending_order()) {
+        descending.push_back(value);
+    }
+    CHECK(descending == vector<string>(ascending.rbegin(), ascending.rend()));
+    CHECK(descending == vector<string>{"pear", "kiwi", "fig", "fig", "apple"});
+
+    // Both orders are served by the one cached permutation
+    IndexBuffer shared = c.getAscendingIndices();
+    auto it = c.begin_descending_order();
+    CHECK(*it == c.getData()[(*shared)[shared->size() - 1]]);
+    CHECK(c.getAscendingIndices() == shared);
+}
+
+// Side-cross positions are computed from the shared sorted permutation, without a second buffer
+TEST_CASE("Side-cross order is computed from the sorted permutation") {
+    for (int n = 0; n <= 9; ++n) {
+        MyContainer<int> c;
+        for (int i = 0; i < n; ++i) {
+            c.addElement((i * 5) % 7);
+        }
+
+        // Reference: two-pointer walk over the ascending order
+        vector<int> sorted;
+        for (int value : c.ascending_order()) {
+            sorted.push_back(value);
+        }
+        vector<int> expected;
+        for (int left = 0, right = n - 1; left <= right; ++left, --right) {
+            expected.push_back(sorted[left]);
+            if (left != right) {
+                expected.push_back(sorted[right]);
+            }
+        }
+
+        size_t before = allocation_count;
+        auto it = c.begin_side_cross_order();  // Permutation already cached: no allocation
+        CHECK(allocation_count == before);
+
+        vector<int> result;
+        for (; it != c.end_side_cross_order(); ++it) {
+            result.push_back(*it);
+        }
+        CHECK(result == expected);
+    }
+}
+
+// Middle-out positions are computed arithmetically, without any allocation
+TEST_CASE("Middle-out order is computed without an index vector") {
+    for (int n = 0; n <= 10; ++n) {
+        MyContainer<int> c;
+        for (int i = 0; i < n; ++i) {
+            c.addElement(i);  // Value == index, so the traversal shows the positions
+        }
+
+        // Reference: fan out from the middle, skipping positions outside the container
+        vector<int> expected;
+        if (n > 0) {
+            int mid = n / 2;
+            expected.push_back(mid);
+            for (int offset = 1; (int)expected.size() < n; ++offset) {
+                if (mid - offset >= 0) expected.push_back(mid - offset);
+                if (mid + offset < n) expected.push_back(mid + offset);
+            }
+        }
+
+        size_t before = allocation_count;
+        auto it = c.begin_middle_out_order();
+        auto end = c.end_middle_out_order();
+        CHECK(allocation_count == before);
+
+        vector<int> result;
+        for (; it != end; ++it) {
+            result.push_back(*it);
+        }
+        CHECK(result == expected);
+    }
+}
+
+// Radix keys must order values exactly like operator<
+TEST_CASE("Radix sort kernel matches comparison sort for numeric types") {
+    CHECK(RadixKey<int>::is_radix_sortable);
+    CHECK(RadixKey<double>::is_radix_sortable);
+    CHECK_FALSE(RadixKey<string>::is_radix_sortable);
+    CHECK_FALSE(RadixKey<bool>::is_radix_sortable);
+
+    CHECK(RadixKey<int>::toKey(-5) < RadixKey<int>::toKey(3));
+    CHECK(RadixKey<float>::toKey(-2.5f) < RadixKey<float>::toKey(-1.0f));
+    CHECK(RadixKey<double>::toKey(-0.0) == RadixKey<double>::toKey(0.0));
+
+    vector<long long> integers;
+    vector<double> doubles;
+    for (int i = 0; i < 2000; ++i) {
+        integers.push_back((i * 2654435761LL) % 100003 - 50000);
+        doubles.push_back(((i * 7919) % 1000 - 500) / 7.0);
+    }
+    integers.push_back(numeric_limits<long long>::min());
+    integers.push_back(numeric_limits<long long>::max());
+    doubles.push_back(-numeric_limits<double>::infinity());
+
+    auto radix = [](const auto& data, vector<size_t>& indices) { radixSortIndices(data, indices); };
+    auto comparison = [](const auto& data, vector<size_t>& indices) { comparisonSortIndices(data, indices); };
+    CHECK(valuesAt(integers, sortedBy(integers, radix)) == valuesAt(integers, sortedBy(integers, comparison)));
+    CHECK(valuesAt(doubles, sortedBy(doubles, radix)) == valuesAt(doubles, sortedBy(doubles, comparison)));
+
+    // Large numeric containers go through the radix path
+    MyContainer<double> c;
+    for (double value : doubles) {
+        c.addElement(value);
+    }
+    vector<double> result;
+    for (double value : c.ascending_order()) {
+        result.push_back(value);
+    }
+    CHECK(result == valuesAt(doubles, sortedBy(doubles, comparison)));
+}
+
+// The parallel path must give exactly the sequential element order
+TEST_CASE("Parallel sort path matches the sequential path") {
+    MyContainer<int> sequential, parallel;
+    MyContainer<string> words;
+    parallel.setSortThreads(4);
+    parallel.setParallelSortThreshold(1000);
+    words.setSortThreads(3);
+    words.setParallelSortThreshold(1000);
+    CHECK(parallel.getSortThreads() == 4);
+    CHECK(parallel.getParallelSortThreshold() == 1000);
+
+    for (int i = 0; i < 5001; ++i) {
+        int value = (i * 7919) % 613;
+        sequential.addElement(value);
+        parallel.addElement(value);
+        words.addElement(to_string(value));
+    }
+
+    vector<int> expected, result;
+    for (int value : sequential.ascending_order()) {
+        expected.push_back(value);
+    }
+    for (int value : parallel.ascending_order()) {
+        result.push_back(value);
+    }
+    CHECK(result == expected);
+
+    vector<string> sorted_words;
+    for (const string& value : words.ascending_order()) {
+        sorted_words.push_back(value);
+    }
+    CHECK(is_sorted(sorted_words.begin(), sorted_words.end()));
+    CHECK(sorted_words.size() == 5001);
+
+    // Odd number of runs, straight through the kernel
+    vector<int> data(expected.rbegin(), expected.rend());
+    auto five_threads = [](const vector<int>& values, vector<size_t>& indices) {
+        parallelSortIndices(values, indices, 5);
+    };
+    CHECK(valuesAt(data, sortedBy(data, five_threads)) == expected);
+}
+
+// Pair and packed kernels sort contiguous copies of the keys and break ties by index
+TEST_CASE("Key/index pair kernels match the indirect comparison sort") {
+    vector<int> ints;
+    vector<float> floats;
+    for (int i = 0; i < 300; ++i) {
+        ints.push_back((i * 37) % 41 - 20);
+        floats.push_back(((i * 53) % 17 - 8) * 0.5f);
+    }
+
+    auto comparison = [](const auto& data, vector<size_t>& indices) { comparisonSortIndices(data, indices); };
+    auto pairs = [](const auto& data, vector<size_t>& indices) { pairSortIndices(data, indices); };
+    auto packed = [](const auto& data, vector<size_t>& indices) { packedSortIndices(data, indices); };
+
+    vector<size_t> by_pairs = sortedBy(ints, pairs);
+    vector<size_t> by_packed = sortedBy(ints, packed);
+    CHECK(valuesAt(ints, by_pairs) == valuesAt(ints, sortedBy(ints, comparison)));
+    CHECK(by_packed == by_pairs);  // Both break ties by index, so the permutations agree exactly
+    CHECK(valuesAt(floats, sortedBy(floats, packed)) == valuesAt(floats, sortedBy(floats, comparison)));
+
+    CHECK(hasPackableKey<int>());
+    CHECK_FALSE(hasPackableKey<double>());
+    CHECK(isPairSortable<double>());
+    CHECK_FALSE(isPairSortable<string>());
+}
+
+// Permutations use 2, 4 or 8 bytes per index depending on the container size
+TEST_CASE("Permutation storage picks the narrowest index width") {
+    vector<size_t> indices = {2, 0, 1};
+    IndexPermutation small(vector<size_t>(indices), 3);
+    CHECK(small.getWidth() == 2);
+    CHECK(small.size() == 3);
+    CHECK(small[0] == 2);
+    CHECK(small.toVector() == indices);
+
+    CHECK(IndexPermutation(vector<size_t>(indices), 65536).getWidth() == 2);
+    CHECK(IndexPermutation(vector<size_t>(indices), 65537).getWidth() == 4);
+    CHECK(IndexPermutation(vector<size_t>(indices), 70000).toVector() == indices);
+
+    MyContainer<int> c;
+    for (int i = 0; i < 66000; ++i) {
+        c.addElement((i * 7919) % 66000 + 1);  // Shuffled 1..66000
+    }
+    CHECK(c.getAscendingIndices()->getWidth() == 4);
+    CHECK(*c.begin_ascending_order() == 1);
+    CHECK(*c.begin_descending_order() == 66000);
+
+    for (int value = 1; value <= 500; ++value) {
+        c.removeElement(value);
+    }
+    CHECK(c.size() == 65500);
+    CHECK(c.getAscendingIndices()->getWidth() == 2);
+    CHECK(*c.begin_ascending_order() == 501);
+}
+
+// Data that arrives in order is traversed without sorting or storing indices
+TEST_CASE("Sortedness tracking skips the sort for ordered data") {
+    MyContainer<int> c;
+    CHECK(c.isSortedAscending());
+    CHECK(c.isSortedDescending());
+
+    for (int value : {1, 2, 2, 5, 9}) {
+        c.addElement(value);
+    }
+    CHECK(c.isSortedAscending());
+    CHECK_FALSE(c.isSortedDescending());
+    CHECK(c.getAscendingIndices()->getLayout() == IndexPermutation::Layout::Identity);
+    CHECK(c.getAscendingIndices()->getWidth() == 0);
+
+    vector<int> result;
+    for (int value : c.descending_order()) {
+        result.push_back(value);
+    }
+    CHECK(result == vector<int>{9, 5, 2, 2, 1});
+
+    c.removeElement(2);  // Removal keeps the data ordered
+    CHECK(c.isSortedAscending());
+
+    c.addElement(3);  // Out of order: falls back to a real sort
+    CHECK_FALSE(c.isSortedAscending());
+    CHECK(c.getAscendingIndices()->getLayout() == IndexPermutation::Layout::Narrow);
+    result.clear();
+    for (int value : c.ascending_order()) {
+        result.push_back(value);
+    }
+    CHECK(result == vector<int>{1, 3, 5, 9});
+
+    MyContainer<string> words;
+    for (const char* word : {"pear", "kiwi", "fig", "fig", "apple"}) {
+        words.addElement(word);
+    }
+    CHECK(words.isSortedDescending());
+    CHECK(words.getAscendingIndices()->getLayout() == IndexPermutation::Layout::Reversed);
+    vector<string> sorted_words;
+    for (const string& word : words.side_cross_order()) {
+        sorted_words.push_back(word);
+    }
+    CHECK(sorted_words == vector<string>{"apple", "pear", "fig", "kiwi", "fig"});
+}
+
+// Natural merge sort detects existing runs and must agree with the comparison sort
+TEST_CASE("Run-adaptive natural merge sort") {
+    auto natural = [](const vector<int>& data, vector<size_t>& indices) { naturalMergeSortIndices(data, indices); };
+    auto pairs = [](const vector<int>& data, vector<size_t>& indices) { pairSortIndices(data, indices); };
+
+    vector<int> sawtooth, reversed, random_values;
+    for (int i = 0; i < 1000; ++i) {
+        sawtooth.push_back(i % 100);
+        reversed.push_back((1000 - i) / 3);  // Descending with ties
+        random_values.push_back((i * 7919) % 1009);
+    }
+
+    // Stable: ties keep insertion order, exactly like the index tie-break of the pair kernel
+    CHECK(sortedBy(sawtooth, natural) == sortedBy(sawtooth, pairs));
+    CHECK(sortedBy(reversed, natural) == sortedBy(reversed, pairs));
+    CHECK(sortedBy(random_values, natural) == sortedBy(random_values, pairs));
+
+    vector<size_t> identity_indices = sortedBy(sawtooth, [](const vector<int>&, vector<size_t>&) {});
+    CHECK(countNaturalRuns(sawtooth, identity_indices, 1000) == 10);
+    CHECK(isPresorted(sawtooth, identity_indices));
+    CHECK(isPresorted(reversed, identity_indices));
+    CHECK_FALSE(isPresorted(random_values, identity_indices));
+}
+
+// Element type whose order only looks at key, so ties are observable through name
+struct Record {
+    int key;
+    string name;
+
+    bool operator<(const Record& other) const {
+        return key < other.key;
+    }
+
+    bool operator>(const Record& other) const {
+        return other < *this;
+    }
+};
+
+// Stable ordering keeps equal elements in insertion order in every sort-based order
+TEST_CASE("Stable ordering breaks ties by insertion index") {
+    MyContainer<Record> c;
+    c.setStableOrdering(true);
+    CHECK(c.isStableOrdering());
+    for (int i = 0; i < 300; ++i) {
+        c.addElement(Record{(i * 17) % 7, "r" + to_string(i)});
+    }
+
+    vector<size_t> expected(c.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        expected[i] = i;
+    }
+    stable_sort(expected.begin(), expected.end(),
+                [&](size_t a, size_t b) { return c.getData()[a] < c.getData()[b]; });
+    CHECK(c.getAscendingIndices()->toVector() == expected);
+
+    vector<string> names;
+    for (const Record& record : c.ascending_order()) {
+        names.push_back(record.name);
+    }
+    CHECK(names[0] == "r0");
+    CHECK(names[1] == "r7");
+
+    // Descending visits the keys from the back but each group of equal keys from the front
+    vector<size_t> expected_descending(expected.size());
+    for (size_t i = 0; i < expected_descending.size(); ++i) {
+        expected_descending[i] = i;
+    }
+    stable_sort(expected_descending.begin(), expected_descending.end(),
+                [&](size_t a, size_t b) { return c.getData()[b] < c.getData()[a]; });
+    vector<string> descending;
+    for (const Record& record : c.descending_order()) {
+        descending.push_back(record.name);
+    }
+    CHECK(descending.size() == expected_descending.size());
+    for (size_t i = 0; i < descending.size(); ++i) {
+        CHECK(descending[i] == c.getData()[expected_descending[i]].name);
+    }
+    CHECK(c.begin_descending_order()[3].name == descending[3]);
+
+    // Side-cross alternates the first unvisited of each end, so ties also stay in insertion order
+    MyContainer<Record> small;
+    small.setStableOrdering(true);
+    small.addElements({Record{2, "b0"}, Record{1, "a0"}, Record{2, "b1"}, Record{1, "a1"}, Record{2, "b2"}});
+    vector<string> cross;
+    for (const Record& record : small.side_cross_order()) {
+        cross.push_back(record.name);
+    }
+    CHECK(cross == vector<string>{"a0", "b0", "a1", "b1", "b2"});
+    descending.clear();
+    for (auto it = small.begin_descending_order(); it != small.end_descending_order(); ++it) {
+        descending.push_back(it->name);
+    }
+    CHECK(descending == vector<string>{"b0", "b1", "b2", "a0", "a1"});
+    vector<Record> block(5);
+    CHECK(small.begin_descending_order().next_batch(block.data(), block.size()) == 5);
+    CHECK(block[1].name == "b1");
+
+    MyContainer<Record> tied;  // All equal: every order is insertion order
+    tied.setStableOrdering(true);
+    tied.addElements({Record{0, "t0"}, Record{0, "t1"}, Record{0, "t2"}});
+    cross.clear();
+    for (const Record& record : tied.side_cross_order()) {
+        cross.push_back(record.name);
+    }
+    CHECK(cross == vector<string>{"t0", "t1", "t2"});
+
+    // Without ties the stable orders reuse the ascending permutation
+    MyContainer<int> distinct;
+    distinct.setStableOrdering(true);
+    distinct.addElements({3, 1, 2});
+    CHECK(distinct.getDescendingIndices() == distinct.getAscendingIndices());
+    CHECK(distinct.getSideCrossIndices() == distinct.getAscendingIndices());
+
+    // Already descending input must not simply be reversed
+    MyContainer<Record> falling;
+    falling.setStableOrdering(true);
+    for (int i = 0; i < 100; ++i) {
+        falling.addElement(Record{(100 - i) / 10, "f" + to_string(i)});
+    }
+    CHECK(falling.isSortedDescending());
+    IndexBuffer order = falling.getAscendingIndices();
+    CHECK((*order)[0] == 91);
+    CHECK((*order)[1] == 92);
+
+    // Same for the parallel path
+    MyContainer<Record> parallel;
+    parallel.setStableOrdering(true);
+    parallel.setSortThreads(3);
+    parallel.setParallelSortThreshold(100);
+    for (const Record& record : c.getData()) {
+        parallel.addElement(record);
+    }
+    CHECK(parallel.getAscendingIndices()->toVector() == expected);
+}
+
+// The lazy heap breaks ties by index, so it visits equal elements like the stable orders
+TEST_CASE("Lazily sorted iterators keep insertion order for equal elements") {
+    MyContainer<Record> c;
+    c.setStableOrdering(true);
+    for (int i = 0; i < 200; ++i) {
+        c.addElement(Record{(i * 37) % 11, "r" + to_string(i)});
+    }
+
+    vector<string> eager, lazy;
+    for (const Record& record : c.ascending_order()) {
+        eager.push_back(record.name);
+    }
+    for (const Record& record : c.lazy_ascending_order()) {
+        lazy.push_back(record.name);
+    }
+    CHECK(lazy == eager);
+
+    eager.clear();
+    lazy.clear();
+    for (const Record& record : c.descending_order()) {
+        eager.push_back(record.name);
+    }
+    for (auto it = c.begin_lazy_descending_order(); it != c.end_lazy_descending_order(); ++it) {
+        lazy.push_back(it->name);
+    }
+    CHECK(lazy == eager);
+}
+
+// Bulk insertion adds a whole batch with one version change
+TEST_CASE("Bulk insertion with a single version bump") {
+    MyContainer<int> c;
+    c.reserve(100);
+    CHECK(c.getVersion() == 0);
+
+    c.addElements({5, 6, 7});
+    CHECK(c.getVersion() == 1);
+    CHECK(c.isSortedAscending());
+
+    vector<int> more = {1, 9, 3};
+    c.addElements(more.begin(), more.end());
+    CHECK(c.getVersion() == 2);
+    CHECK(c.size() == 6);
+    CHECK_FALSE(c.isSortedAscending());
+    CHECK(captureOutput(c) == "[5, 6, 7, 1, 9, 3]");
+
+    c.addElements(more.end(), more.end());  // Nothing added, nothing changed
+    CHECK(c.getVersion() == 2);
+
+    // Input iterators work too
+    istringstream input("4 8");
+    c.addElements(istream_iterator<int>(input), istream_iterator<int>());
+    CHECK(c.getVersion() == 3);
+
+    vector<int> result;
+    for (int value : c.ascending_order()) {
+        result.push_back(value);
+    }
+    CHECK(result == vector<int>{1, 3, 4, 5, 6, 7, 8, 9});
+
+    // Incremental mode merges the batch as one sorted delta
+    c.setIncrementalSorting(true);
+    c.addElements({0, 10, 2});
+    result.clear();
+    for (int value : c.ascending_order()) {
+        result.push_back(value);
+    }
+    CHECK(result == vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+
+    // Adopting constructor takes the storage without copying
+    vector<string> words = {"b", "a", "c"};
+    const string* storage = words.data();
+    MyContainer<string> adopted(move(words));
+    CHECK(adopted.size() == 3);
+    CHECK(adopted.getData().data() == storage);
+    CHECK_FALSE(adopted.isSortedAscending());
+    CHECK(*adopted.begin_ascending_order() == "a");
+}
+
+// Counts copies, so tests can check that elements are moved and dereferenced without copying
+struct CopyCounter {
+    static int copies;
+    int value;
+
+    explicit CopyCounter(int v) : value(v) {}
+    CopyCounter(const CopyCounter& other) : value(other.value) { ++copies; }
+    CopyCounter(CopyCounter&& other) noexcept : value(other.value) {}
+    CopyCounter& operator=(const CopyCounter& other) { value = other.value; ++copies; return *this; }
+    CopyCounter& operator=(CopyCounter&& other) noexcept { value = other.value; return *this; }
+
+    bool operator<(const CopyCounter& other) const { return value < other.value; }
+    bool operator>(const CopyCounter& other) const { return value > other.value; }
+};
+int CopyCounter::copies = 0;
+
+// Heavy and move-only element types flow through the container without copies
+TEST_CASE("Move-aware insertion, emplace and reference dereference") {
+    CopyCounter::copies = 0;
+    MyContainer<CopyCounter> c;
+    CopyCounter moved(3);
+    c.addElement(move(moved));
+    c.emplaceElement(1);
+    c.emplaceElement(2);
+    vector<CopyCounter> batch;
+    batch.emplace_back(0);
+    c.addElements(make_move_iterator(batch.begin()), make_move_iterator(batch.end()));
+    CHECK(c.size() == 4);
+    CHECK(CopyCounter::copies == 0);
+
+    int sum = 0;
+    for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) {
+        const CopyCounter& element = *it;  // Reference into the container
+        sum += element.value;
+    }
+    for (const CopyCounter& element : c.side_cross_order()) {
+        sum += element.value;
+    }
+    for (const CopyCounter& element : c.top_k(2)) {
+        sum += element.value;
+    }
+    CHECK(sum == 6 + 6 + 5);
+    CHECK(&*c.begin_order() == &c.getData()[0]);
+    CHECK(CopyCounter::copies == 0);
+
+    // Move-only elements
+    MyContainer<unique_ptr<int>> owners;
+    owners.addElement(make_unique<int>(7));
+    owners.emplaceElement(new int(8));
+    vector<int> values;
+    for (const unique_ptr<int>& owner : owners.reverse_order()) {
+        values.push_back(*owner);
+    }
+    CHECK(values == vector<int>{8, 7});
+}
+
+// Element type without std::hash, so batch removal falls back to sorted lookups
+struct Point {
+    int x;
+    int y;
+
+    bool operator<(const Point& other) const {
+        return x < other.x || (x == other.x && y < other.y);
+    }
+    bool operator==(const Point& other) const {
+        return x == other.x && y == other.y;
+    }
+};
+
+// Batch removal compacts the container once and bumps the version at most once
+TEST_CASE("Batch removal, removeIf and tryRemove") {
+    MyContainer<int> c;
+    for (int i = 0; i < 20; ++i) {
+        c.addElement(i % 10);
+    }
+    size_t version = c.getVersion();
+
+    CHECK(c.removeElements(vector<int>{1, 3, 42}) == 4);
+    CHECK(c.getVersion() == version + 1);
+    CHECK(c.size() == 16);
+
+    CHECK(c.removeElements({5, 7}) == 4);
+    CHECK(c.removeElements(vector<int>{}) == 0);
+    CHECK(c.removeElements({100}) == 0);
+    CHECK(c.getVersion() == version + 2);  // Nothing removed, nothing changed
+
+    CHECK(c.removeIf([](int value) { return value % 2 == 0; }) == 10);
+    CHECK(captureOutput(c) == "[9, 9]");
+    CHECK(c.getVersion() == version + 3);
+
+    CHECK(c.tryRemove(4) == 0);
+    CHECK_NOTHROW(c.tryRemove(4));
+    CHECK(c.tryRemove(9) == 2);
+    CHECK(c.size() == 0);
+
+    // Iterators notice batch removal like any other change
+    MyContainer<string> words;
+    words.addElements({"a", "b", "c", "b"});
+    auto it = words.begin_ascending_order();
+    CHECK(words.removeElements(vector<string>{"b"}) == 2);
+    CHECK_THROWS_AS(*it, runtime_error);
+    CHECK(*words.begin_descending_order() == "c");
+
+    // Non-hashable element types use the sorted lookup
+    MyContainer<Point> points;
+    points.addElements({Point{1, 2}, Point{3, 4}, Point{1, 2}, Point{5, 6}});
+    CHECK_FALSE(IsHashable<Point>::value);
+    CHECK(points.removeElements(vector<Point>{Point{1, 2}, Point{9, 9}}) == 2);
+    CHECK(points.size() == 2);
+    CHECK(points.begin_ascending_order()->x == 3);
+}
+
+// The multiplicity index answers membership queries and stays exact through every add and remove path
+TEST_CASE("Membership and multiplicity index") {
+    MyContainer<int> c(vector<int>{4, 2, 4});
+    CHECK(c.count(4) == 2);  // Linear scan without the index
+    CHECK_FALSE(c.contains(7));
+
+    c.setMembershipIndex(true);
+    CHECK(c.isMembershipIndexed());
+    CHECK(c.count(4) == 2);
+    CHECK(c.contains(2));
+
+    c.addElement(7);
+    int nine = 9;
+    c.addElement(std::move(nine));
+    c.emplaceElement(7);
+    c.addElements({1, 1, 1});
+    CHECK(c.count(7) == 2);
+    CHECK(c.count(9) == 1);
+    CHECK(c.count(1) == 3);
+
+    size_t version = c.getVersion();
+    CHECK_THROWS_AS(c.removeElement(100), runtime_error);
+    CHECK(c.tryRemove(100) == 0);
+    CHECK(c.removeElements({100, 200}) == 0);
+    CHECK(c.getVersion() == version);
+
+    c.removeElement(4);
+    CHECK_FALSE(c.contains(4));
+    CHECK(c.removeElements({1, 7, 100}) == 5);
+    CHECK(c.removeIf([](int value) { return value > 8; }) == 1);
+    CHECK(captureOutput(c) == "[2]");
+    CHECK(c.count(2) == 1);
+    CHECK(c.count(1) == 0);
+    CHECK_FALSE(c.contains(9));
+
+    // Disabling falls back to scanning the same data
+    c.setMembershipIndex(false);
+    CHECK(c.count(2) == 1);
+
+    // Types without std::hash still support the scanning queries
+    MyContainer<Point> points;
+    points.addElements({Point{1, 2}, Point{1, 2}});
+    CHECK(points.count(Point{1, 2}) == 2);
+    CHECK_FALSE(points.contains(Point{0, 0}));
+    CHECK_NOTHROW(points.setMembershipIndex(false));
+    CHECK_THROWS_AS(points.setMembershipIndex(true), logic_error);
+    CHECK_FALSE(points.isMembershipIndexed());
+}
+
+// Every order is position-based, so all iterators are random-access and usable with standard algorithms
+TEST_CASE("Random-access iterators and standard algorithms") {
+    static_assert(std::is_same<iterator_traits<AscendingOrderIterator<int>>::iterator_category,
+                               random_access_iterator_tag>::value, "ascending order is random access");
+    static_assert(std::is_same<iterator_traits<MiddleOutOrderIterator<int>>::iterator_category,
+                               random_access_iterator_tag>::value, "middle-out order is random access");
+    static_assert(std::is_same<iterator_traits<TopKOrderIterator<int>>::iterator_category,
+                               random_access_iterator_tag>::value, "top-k order is random access");
+    static_assert(std::is_same<iterator_traits<LazyAscendingOrderIterator<int>>::iterator_category,
+                               random_access_iterator_tag>::value, "lazy order is random access");
+
+    MyContainer<int> c;
+    c.addElements({7, 15, 6, 1, 2});
+
+    // O(1) distance and binary search over the ascending order: 1, 2, 6, 7, 15
+    auto first = c.begin_ascending_order();
+    auto last = c.end_ascending_order();
+    CHECK(std::distance(first, last) == 5);
+    CHECK(*std::lower_bound(first, last, 6) == 6);
+    CHECK(std::lower_bound(first, last, 8) - first == 4);
+    CHECK(std::binary_search(first, last, 15));
+    CHECK_FALSE(std::binary_search(first, last, 3));
+
+    // Seeks, indexing and ordering
+    CHECK(first[3] == 7);
+    CHECK(*(first + 2) == 6);
+    CHECK(*(2 + first) == 6);
+    CHECK(first < last);
+    CHECK(last >= first + 5);
+    CHECK(last == first + 5);
+
+    // End iterators can walk back onto elements
+    CHECK(*(--c.end_ascending_order()) == 15);
+    CHECK(*(c.end_descending_order() - 1) == 1);
+    CHECK(*(c.end_side_cross_order() - 1) == 6);   // Side-cross: 1, 15, 2, 7, 6
+    CHECK(c.begin_side_cross_order()[3] == 7);
+    CHECK(c.begin_descending_order()[1] == 7);
+    CHECK(c.begin_reverse_order()[1] == 1);         // Reverse: 2, 1, 6, 15, 7
+    CHECK(*(c.end_reverse_order() - 1) == 7);
+    CHECK(c.begin_order()[2] == 6);
+    CHECK(*(c.end_order() - 1) == 2);
+    CHECK(c.begin_middle_out_order()[2] == 1);      // Middle-out: 6, 15, 1, 7, 2
+    CHECK(*(c.end_middle_out_order() - 1) == 2);
+    CHECK(*(c.end_lazy_ascending_order() - 2) == 7);  // Builds the heap it skipped
+    CHECK(c.begin_lazy_descending_order()[3] == 2);
+    CHECK(*(c.end_top_k(3) - 1) == 6);                // Top 3: 15, 7, 6
+    CHECK(c.begin_bottom_k(2)[1] == 2);
+
+    // Moving outside [begin, end] throws, postfix decrement returns the old position
+    auto it = c.begin_order();
+    CHECK_THROWS_AS(--it, out_of_range);
+    CHECK_THROWS_AS(it += 6, out_of_range);
+    CHECK_THROWS_AS(it -= 1, out_of_range);
+    it += 5;
+    auto before = it--;
+    CHECK(before == c.end_order());
+    CHECK(*it == 2);
+
+    // Seeking after a modification is detected like stepping
+    auto stale = c.begin_ascending_order();
+    c.addElement(3);
+    CHECK_THROWS_AS(stale += 1, runtime_error);
+    CHECK_THROWS_AS(stale[0], runtime_error);
+}
+
+// operator-> reaches members of the current element in place, with the same checks as operator*
+TEST_CASE("Member access through operator->") {
+    MyContainer<Record> records;
+    records.addElement(Record{3, "three"});
+    records.addElement(Record{1, "one"});
+    records.addElement(Record{2, "two"});
+
+    CHECK(records.begin_ascending_order()->name == "one");
+    CHECK(records.begin_descending_order()->name == "three");
+    CHECK(records.begin_side_cross_order()->key == 1);
+    CHECK(records.begin_reverse_order()->name == "two");
+    CHECK(records.begin_order()->name == "three");
+    CHECK(records.begin_middle_out_order()->name == "one");
+    CHECK(records.begin_lazy_ascending_order()->key == 1);
+    CHECK(records.begin_bottom_k(1)->name == "one");
+
+    // The pointer refers to the stored element itself
+    auto it = records.begin_order();
+    CHECK(it.operator->() == &records.getData()[0]);
+
+    CHECK_THROWS_AS(records.end_ascending_order()->key, out_of_range);
+    auto stale = records.begin_bottom_k(2);
+    records.addElement(Record{0, "zero"});
+    CHECK_THROWS_AS(stale->name, runtime_error);
+}
+
+// The checking policy is a compile-time choice; unchecked traversals see the same elements
+TEST_CASE("Checking policies") {
+    static_assert(Checked::enabled, "Checked always validates");
+    static_assert(!Unchecked::enabled, "Unchecked never validates");
+#ifdef NDEBUG
+    static_assert(std::is_same<DebugOnly, Unchecked>::value, "DebugOnly is Unchecked with NDEBUG");
+#else
+    static_assert(std::is_same<DebugOnly, Checked>::value, "DebugOnly is Checked without NDEBUG");
+#endif
+    static_assert(std::is_same<MyContainer<int>, MyContainer<int, Checked>>::value, "Checked is the default");
+
+    MyContainer<int, Unchecked> fast;
+    MyContainer<int> safe;
+    for (int value : {5, 3, 9, 1, 7}) {
+        fast.addElement(value);
+        safe.addElement(value);
+    }
+
+    vector<int> fast_order;
+    for (int value : fast.side_cross_order()) {
+        fast_order.push_back(value);
+    }
+    vector<int> safe_order;
+    for (int value : safe.side_cross_order()) {
+        safe_order.push_back(value);
+    }
+    CHECK(fast_order == safe_order);
+    CHECK(*std::lower_bound(fast.begin_ascending_order(), fast.end_ascending_order(), 6) == 7);
+    CHECK(*fast.begin_top_k(1) == 9);
+    CHECK(*fast.begin_lazy_descending_order() == 9);
+
+    // Unchecked iterators skip the version check: still in bounds after an append, nothing throws
+    auto it = fast.begin_order();
+    fast.addElement(11);
+    CHECK_NOTHROW(*it);
+    CHECK(*it == 5);
+
+    // The default policy keeps the existing guarantee
+    auto checked = safe.begin_order();
+    safe.addElement(11);
+    CHECK_THROWS_AS(*checked, runtime_error);
+}
+
+// Hoisted checking validates in the loop condition instead of on every element
+TEST_CASE("Hoisted checking policy") {
+    MyContainer<int, Hoisted> c;
+    c.addElements({4, 8, 15, 16, 23, 42});
+
+    vector<int> seen;
+    for (int value : c.descending_order()) {
+        seen.push_back(value);
+    }
+    CHECK(seen == vector<int>{42, 23, 16, 15, 8, 4});
+
+    // A modification inside the loop is reported at the latest when the loop reaches its end
+    size_t steps = 0;
+    auto modify_during_loop = [&] {
+        for (int value : c.order()) {
+            ++steps;
+            if (value == 15) {
+                c.addElement(99);
+            }
+        }
+    };
+    CHECK_THROWS_AS(modify_during_loop(), runtime_error);
+    CHECK(steps == 6);
+
+    // ... and in long traversals at the next multiple of Hoisted::interval
+    MyContainer<int, Hoisted> large;
+    for (int i = 0; i < 3000; ++i) {
+        large.addElement(i % 97);
+    }
+    steps = 0;
+    auto modify_large = [&] {
+        for (auto it = large.begin_ascending_order(); it != large.end_ascending_order(); ++it) {
+            if (++steps == 10) {
+                large.addElement(5);
+            }
+        }
+    };
+    CHECK_THROWS_AS(modify_large(), runtime_error);
+    CHECK(steps == Hoisted::interval);
+
+    // Shrinking the container is caught before a removed element is read
+    MyContainer<string, Hoisted> words;
+    words.addElements({"alpha", "beta", "gamma", "delta"});
+    vector<string> read;
+    auto shrink_during_loop = [&] {
+        for (const string& word : words.reverse_order()) {
+            read.push_back(word);
+            words.removeIf([](const string& candidate) { return candidate != "alpha"; });
+        }
+    };
+    CHECK_THROWS_AS(shrink_during_loop(), runtime_error);
+    CHECK(read == vector<string>{"delta"});
+
+    // The same holds for permutation-based orders, which map positions through stored indices
+    words.addElements({"beta", "gamma", "delta"});
+    auto ascending = words.begin_ascending_order();
+    auto top = words.begin_top_k(2);
+    words.removeElement("gamma");
+    CHECK_THROWS_AS(*ascending, runtime_error);
+    CHECK_THROWS_AS(ascending[2], runtime_error);
+    CHECK_THROWS_AS(*top, runtime_error);
+
+    // Comparisons check at the first position and at the end, not in between
+    auto stale = c.begin_order();
+    auto end = c.end_order();
+    c.addElement(1);
+    CHECK_THROWS_AS((void)(stale != end), runtime_error);
+    CHECK_THROWS_AS((void)(stale == OrderSentinel(6)), runtime_error);
+    ++stale;
+    CHECK_NOTHROW((void)(stale == OrderSentinel(6)));
+    CHECK_THROWS_AS((void)(stale + 5 == OrderSentinel(6)), runtime_error);
+
+    // Dereference skips the version check but never reads past the end
+    CHECK_NOTHROW(*stale);
+    CHECK_THROWS_AS(*c.end_ascending_order(), out_of_range);
+    CHECK_THROWS_AS(*c.end_order(), out_of_range);
+
+    // The loop condition tests for the end or beyond, so the compiler can drop the bounds check
+    CHECK(c.begin_order() + 3 == OrderSentinel(2));
+
+    // Default-constructed iterators compare equal without touching a container
+    AscendingOrderIterator<int, Hoisted> first_default;
+    AscendingOrderIterator<int, Hoisted> second_default;
+    CHECK(first_default == second_default);
+    CHECK_FALSE(first_default != second_default);
+    CHECK_FALSE(TopKOrderIterator<int, Hoisted>() != TopKOrderIterator<int, Hoisted>());
+    CHECK(OrderIterator<int, Hoisted>() == OrderSentinel(0));
+}
+
+// Reads every element of an order through next_batch, capacity elements at a time
+template<typename Iterator>
+vector<int> readInBatches(Iterator it, size_t capacity) {
+    vector<int> values;
+    vector<int> block(capacity);
+    size_t n;
+    while ((n = it.next_batch(block.data(), capacity)) > 0) {
+        CHECK(n <= capacity);
+        values.insert(values.end(), block.begin(), block.begin() + static_cast<long>(n));
+    }
+    return values;
+}
+
+// Reads every element of a range one at a time
+template<typename Range>
+vector<int> readOneByOne(const Range& range) {
+    vector<int> values;
+    for (int value : range) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+// Batched reads yield exactly the per-element order, for every traversal and block size
+TEST_CASE("Batched block iteration") {
+    MyContainer<int> c;
+    c.addElements({7, 15, 6, 1, 2, 9, 4, 4, 12});
+
+    for (size_t capacity : {1, 2, 4, 100}) {
+        CHECK(readInBatches(c.begin_ascending_order(), capacity) == readOneByOne(c.ascending_order()));
+        CHECK(readInBatches(c.begin_descending_order(), capacity) == readOneByOne(c.descending_order()));
+        CHECK(readInBatches(c.begin_side_cross_order(), capacity) == readOneByOne(c.side_cross_order()));
+        CHECK(readInBatches(c.begin_reverse_order(), capacity) == readOneByOne(c.reverse_order()));
+        CHECK(readInBatches(c.begin_order(), capacity) == readOneByOne(c.order()));
+        CHECK(readInBatches(c.begin_middle_out_order(), capacity) == readOneByOne(c.middle_out_order()));
+        CHECK(readInBatches(c.begin_lazy_ascending_order(), capacity) == readOneByOne(c.lazy_ascending_order()));
+        CHECK(readInBatches(c.begin_top_k(4), capacity) == vector<int>{15, 12, 9, 7});
+    }
+
+    // Already sorted and reversed data use the implicit permutations
+    MyContainer<int> rising(vector<int>{1, 2, 3, 4, 5});
+    MyContainer<int> falling(vector<int>{5, 4, 3, 2, 1});
+    CHECK(readInBatches(rising.begin_descending_order(), 2) == vector<int>{5, 4, 3, 2, 1});
+    CHECK(readInBatches(falling.begin_ascending_order(), 3) == vector<int>{1, 2, 3, 4, 5});
+    CHECK(readInBatches(falling.begin_descending_order(), 3) == vector<int>{5, 4, 3, 2, 1});
+
+    // Large enough for 32-bit stored indices
+    vector<int> shuffled(70000);
+    for (size_t i = 0; i < shuffled.size(); ++i) {
+        shuffled[i] = static_cast<int>((i * 7919) % 70001);
+    }
+    MyContainer<int> large(std::move(shuffled));
+    CHECK(large.getAscendingIndices()->getWidth() == 4);
+    CHECK(readInBatches(large.begin_ascending_order(), 1000) == readOneByOne(large.ascending_order()));
+    CHECK(readInBatches(large.begin_descending_order(), 999) == readOneByOne(large.descending_order()));
+
+    // A batch continues from the iterator position and advances it
+    auto it = c.begin_ascending_order() + 3;
+    int block[2];
+    CHECK(it.next_batch(block, 2) == 2);
+    CHECK(block[0] == 4);
+    CHECK(block[1] == 6);
+    CHECK(*it == 7);
+    CHECK(c.end_ascending_order().next_batch(block, 2) == 0);
+
+    // for_each_block visits the whole range in order
+    long long sum = 0;
+    size_t blocks = 0;
+    vector<int> visited;
+    c.ascending_order().for_each_block(4, [&](const int* values, size_t n) {
+        ++blocks;
+        for (size_t i = 0; i < n; ++i) {
+            sum += values[i];
+            visited.push_back(values[i]);
+        }
+    });
+    CHECK(blocks == 3);
+    CHECK(sum == 60);
+    CHECK(visited == readOneByOne(c.ascending_order()));
+    CHECK_THROWS_AS(c.order().for_each_block(0, [](const int*, size_t) {}), invalid_argument);
+
+    // Modifications are detected once per block
+    auto stale = c.begin_order();
+    c.addElement(3);
+    CHECK_THROWS_AS(stale.next_batch(block, 2), runtime_error);
+    auto range = c.order();
+    CHECK_THROWS_AS(range.for_each_block(2, [&](const int*, size_t) { c.addElement(0); }), runtime_error);
+}